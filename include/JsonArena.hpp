@@ -0,0 +1,132 @@
+// Copyright (c) 2023. SugerSalt
+
+#ifndef SUGERJSON_JSONARENA_HPP
+#define SUGERJSON_JSONARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace suger {
+
+// Monotonic bump allocator. Memory is handed out from large blocks and never freed one by one,
+// everything is given back at once by reset() or the destructor.
+class JsonArena {
+public:
+  static const std::size_t kDefaultBlockSize = 4096;
+  static const std::size_t kMaxBlockSize = 1 << 20;
+
+  explicit JsonArena(std::size_t block_size = kDefaultBlockSize);
+  JsonArena(const JsonArena &) = delete;
+  JsonArena &operator=(const JsonArena &) = delete;
+  ~JsonArena();
+
+  void *allocate(std::size_t size, std::size_t align) {
+    auto pos = (reinterpret_cast<uintptr_t>(pos_) + align - 1) & ~(uintptr_t(align) - 1);
+    if (pos_ != nullptr && pos + size <= reinterpret_cast<uintptr_t>(end_)) {
+      pos_ = reinterpret_cast<char *>(pos + size);
+      return reinterpret_cast<void *>(pos);
+    }
+    return allocateSlow(size, align);
+  }
+
+  template<class T, class... Args>
+  T *create(Args &&... args) {
+    return new(allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+
+  // destroy(object) is called when the arena is reset or destroyed, for objects that own
+  // memory outside of the arena
+  void addCleanup(void *object, void (*destroy)(void *));
+
+  // run the cleanups and make all memory available again, the largest block is kept
+  void reset();
+  // bytes of all blocks currently held
+  std::size_t capacity() const;
+
+private:
+  struct Block {
+    Block *next;
+    std::size_t size;
+  };
+  struct Cleanup {
+    void *object;
+    void (*destroy)(void *);
+  };
+
+  Block *head_;
+  char *pos_;
+  char *end_;
+  std::size_t block_size_;
+  std::vector<Cleanup> cleanups_;
+
+  void *allocateSlow(std::size_t size, std::size_t align);
+  void runCleanups();
+};
+
+// Allocator for the containers inside the json tree. Without an arena it uses the heap,
+// deallocate is a no-op for arena memory.
+template<class T>
+class JsonAllocator {
+public:
+  using value_type = T;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  JsonAllocator() noexcept : arena_(nullptr) {}
+  explicit JsonAllocator(JsonArena *arena) noexcept : arena_(arena) {}
+  template<class U>
+  JsonAllocator(const JsonAllocator<U> &other) noexcept : arena_(other.arena()) {}
+
+  T *allocate(std::size_t n) {
+    if (arena_ == nullptr) {
+      return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+    return static_cast<T *>(arena_->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T *p, std::size_t) noexcept {
+    if (arena_ == nullptr) {
+      ::operator delete(p);
+    }
+  }
+
+  // copies never share the arena of the original
+  JsonAllocator select_on_container_copy_construction() const {
+    return JsonAllocator();
+  }
+
+  JsonArena *arena() const noexcept {
+    return arena_;
+  }
+
+private:
+  JsonArena *arena_;
+};
+
+template<class T, class U>
+bool operator==(const JsonAllocator<T> &lhs, const JsonAllocator<U> &rhs) noexcept {
+  return lhs.arena() == rhs.arena();
+}
+
+template<class T, class U>
+bool operator!=(const JsonAllocator<T> &lhs, const JsonAllocator<U> &rhs) noexcept {
+  return lhs.arena() != rhs.arena();
+}
+
+namespace detail {
+
+// whether str keeps its characters on the heap instead of inside the string object
+inline bool usesHeap(const std::string &str) {
+  static const std::size_t inline_capacity = std::string().capacity();
+  return str.capacity() > inline_capacity;
+}
+
+} // detail
+
+} // suger
+
+#endif //SUGERJSON_JSONARENA_HPP
@@ -3,8 +3,10 @@
 #ifndef SUGERJSON_JSONBASE_HPP
 #define SUGERJSON_JSONBASE_HPP
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
-#include <ostream>
+#include <string>
 #include "JsonType.hpp"
 
 namespace suger {
@@ -15,13 +17,34 @@ public:
   using WeakPtr = std::weak_ptr<JsonBase>;
   using UniquePtr = std::unique_ptr<JsonBase>;
 
-  explicit JsonBase(JsonType type) : type_(type) {};
+  explicit JsonBase(JsonType type, bool in_arena = false)
+      : refs_(1), type_(static_cast<uint8_t>(type)), in_arena_(in_arena), shareable_(false) {};
+  // copies are always allocated on the heap
+  JsonBase(const JsonBase &other)
+      : refs_(1), type_(other.type_), in_arena_(false), shareable_(other.shareable_) {};
   virtual ~JsonBase() = default;
 
+  // nodes in an arena are released together with it and must not be deleted
+  bool inArena() const { return in_arena_; }
+
+  // Copies of a shareable node only count it, see JsonValue::share. The JsonValue dropping the
+  // last reference deletes it.
+  bool shareable() const { return shareable_; }
+  void setShareable(bool shareable = true) { shareable_ = shareable; }
+  bool unique() const { return refs_.load(std::memory_order_acquire) == 1; }
+  void ref() { refs_.fetch_add(1, std::memory_order_relaxed); }
+  // whether this was the last reference
+  bool unref() { return unique() || refs_.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
   virtual std::string toString() const = 0;
-  virtual std::ostream &toDumpStream(std::ostream &out) const = 0;
+  // append the json text to out
+  virtual void dump(std::string &out) const = 0;
 private:
-  JsonType type_;
+  // packed next to the vtable pointer, a node header stays 16 bytes
+  std::atomic<uint32_t> refs_;
+  uint8_t type_;
+  bool in_arena_;
+  bool shareable_;
 };
 
 } // suger
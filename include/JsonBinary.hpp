@@ -0,0 +1,51 @@
+// Copyright (c) 2023. SugerSalt
+
+#ifndef SUGERJSON_JSONBINARY_HPP
+#define SUGERJSON_JSONBINARY_HPP
+
+#include <memory>
+#include <string>
+#include "JsonType.hpp"
+#include "JsonValue.hpp"
+
+namespace suger {
+
+namespace detail {
+class ValueStack;
+} // detail
+
+// Encode as CBOR (RFC 8949) or MessagePack. Integers take the shortest form, doubles are
+// written as float when that is exact, strings and keys as text strings.
+std::string toCbor(const JsonValue &value);
+void dumpCbor(const JsonValue &value, std::string &out);
+std::string toMessagePack(const JsonValue &value);
+void dumpMessagePack(const JsonValue &value, std::string &out);
+
+// Decodes CBOR or MessagePack into a JsonValue. Integers become Int or Long by their range like
+// numbers read by JsonReader, floats become Double. Byte strings are read as strings, CBOR tags
+// are skipped and undefined is read as null. Map keys must be strings. Throws parse_error on
+// invalid or truncated data, on extension types, and when bytes follow the value.
+class JsonBinaryReader {
+public:
+  JsonBinaryReader();
+  ~JsonBinaryReader();
+
+  // same as for JsonReader, duplicate keys are rejected by default
+  void setDuplicateKeyPolicy(DuplicateKeyPolicy policy);
+  DuplicateKeyPolicy duplicateKeyPolicy() const;
+  // same as for JsonReader, on by default
+  void setPackedArrays(bool enable);
+  bool packedArrays() const;
+
+  JsonValue parseCbor(const std::string &data);
+  JsonValue parseCbor(const char *data, std::size_t length);
+  JsonValue parseMessagePack(const std::string &data);
+  JsonValue parseMessagePack(const char *data, std::size_t length);
+
+private:
+  std::unique_ptr<detail::ValueStack> stack_;
+};
+
+} // suger
+
+#endif //SUGERJSON_JSONBINARY_HPP
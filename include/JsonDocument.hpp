@@ -0,0 +1,56 @@
+// Copyright (c) 2023. SugerSalt
+
+#ifndef SUGERJSON_JSONDOCUMENT_HPP
+#define SUGERJSON_JSONDOCUMENT_HPP
+
+#include <memory>
+#include "JsonArena.hpp"
+#include "JsonValue.hpp"
+
+namespace suger {
+
+namespace detail {
+class KeyTable;
+} // detail
+
+// A parsed json whose nodes, arrays and objects are all allocated from one arena.
+// Nothing is freed node by node: the tree is released at once when the document is destroyed
+// or parsed into again, the first block of the arena is then reused.
+// The tree is read only, copies of its values are ordinary JsonValue on the heap.
+class JsonDocument {
+  friend class JsonReader;
+
+public:
+  explicit JsonDocument(std::size_t block_size = JsonArena::kDefaultBlockSize);
+  JsonDocument(const JsonDocument &) = delete;
+  JsonDocument &operator=(const JsonDocument &) = delete;
+  ~JsonDocument();
+
+  // Store every distinct key once with its hash and let all objects share it. The keys are
+  // kept when the document is parsed into again, which suits many documents with the same
+  // keys, e.g. read by JsonStreamReader. Off by default.
+  void setKeyInterning(bool enable);
+  bool keyInterning() const;
+
+  const JsonValue &root() const;
+  const JsonValue &operator[](const std::string &key) const;
+  const JsonValue &operator[](const char *key) const;
+  const JsonValue &operator[](std::size_t index) const;
+  const JsonValue &operator[](int index) const;
+
+  // release the tree, the document becomes null
+  void clear();
+  // bytes held by the arena
+  std::size_t capacity() const;
+
+private:
+  // declared first, so the root is destroyed before the memory it points to
+  std::unique_ptr<detail::KeyTable> keys_;
+  bool intern_keys_;
+  JsonArena arena_;
+  JsonValue root_;
+};
+
+} // suger
+
+#endif //SUGERJSON_JSONDOCUMENT_HPP
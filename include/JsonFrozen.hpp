@@ -0,0 +1,140 @@
+// Copyright (c) 2023. SugerSalt
+
+#ifndef SUGERJSON_JSONFROZEN_HPP
+#define SUGERJSON_JSONFROZEN_HPP
+
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include "JsonType.hpp"
+#include "JsonValue.hpp"
+
+namespace suger {
+
+namespace detail {
+struct FrozenData;
+} // detail
+
+class JsonFrozenIterator;
+
+// A value inside a JsonFrozen. It is a small handle which is passed by value and stays valid
+// as long as its document, the accessors are those of a const JsonValue.
+class JsonFrozenValue {
+  friend class JsonFrozen;
+  friend class JsonFrozenIterator;
+
+public:
+  JsonType getType() const;
+  bool isNull() const;
+  bool isBoolean() const;
+  bool isNumber() const;
+  bool isInt() const;
+  bool isLong() const;
+  bool isDouble() const;
+  bool isString() const;
+  bool isArray() const;
+  bool isObject() const;
+
+  bool asBoolean() const;
+  int asInt() const;
+  int64_t asLong() const;
+  double asDouble() const;
+  const std::string &asString() const;
+
+  // throw key_error when there is no such member or element
+  JsonFrozenValue operator[](const std::string &key) const;
+  JsonFrozenValue operator[](const char *key) const;
+  JsonFrozenValue operator[](std::size_t index) const;
+  JsonFrozenValue operator[](int index) const;
+
+  // number of members or elements, 0 for the other types
+  std::size_t size() const;
+  bool empty() const;
+  // members in the order they were inserted, the other types have none
+  JsonFrozenIterator begin() const;
+  JsonFrozenIterator end() const;
+  // the first of equal keys, end() if there is none
+  JsonFrozenIterator find(const std::string &key) const;
+  bool isMember(const std::string &key) const;
+  JsonFrozenIterator at(std::size_t index) const;
+
+  // an ordinary copy of the value
+  JsonValue toValue() const;
+  std::string toString() const;
+  void dump(std::string &out) const;
+
+private:
+  const detail::FrozenData *data_;
+  uint32_t node_;
+
+  JsonFrozenValue(const detail::FrozenData *data, uint32_t node) : data_(data), node_(node) {}
+  // position of key among the members in insertion order, size() if it is not one
+  std::size_t findMember(const char *key, std::size_t length) const;
+};
+
+class JsonFrozenIterator {
+  friend class JsonFrozenValue;
+
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = JsonFrozenValue;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const JsonFrozenValue *;
+  using reference = const JsonFrozenValue &;
+
+  reference operator*() const { return value_; }
+  pointer operator->() const { return &value_; }
+  JsonFrozenIterator &operator++();
+  JsonFrozenIterator operator++(int);
+  bool operator==(const JsonFrozenIterator &rhs) const { return pos_ == rhs.pos_; }
+  bool operator!=(const JsonFrozenIterator &rhs) const { return pos_ != rhs.pos_; }
+
+  // the key of an object member
+  const std::string &key() const;
+  const JsonFrozenValue &value() const { return value_; }
+
+private:
+  // the array or object and the position in it
+  JsonFrozenValue parent_;
+  std::size_t pos_;
+  JsonFrozenValue value_;
+
+  JsonFrozenIterator(const JsonFrozenValue &parent, std::size_t pos);
+  // point value_ to the member at pos_
+  void load();
+};
+
+// An immutable copy of a JsonValue laid out for reading. All values are nodes of 16 bytes in
+// one array, the elements and members of each array and object are next to each other, and
+// every object keeps its keys sorted so members are found by binary search. Strings and keys
+// are stored once. Nothing is changed after construction, so any number of threads may read
+// a document without locking.
+class JsonFrozen {
+public:
+  // a null document
+  JsonFrozen();
+  explicit JsonFrozen(const JsonValue &value);
+  JsonFrozen(JsonFrozen &&other) noexcept;
+  JsonFrozen &operator=(JsonFrozen &&other) noexcept;
+  JsonFrozen(const JsonFrozen &) = delete;
+  JsonFrozen &operator=(const JsonFrozen &) = delete;
+  ~JsonFrozen();
+
+  JsonFrozenValue root() const;
+  JsonFrozenValue operator[](const std::string &key) const;
+  JsonFrozenValue operator[](const char *key) const;
+  JsonFrozenValue operator[](std::size_t index) const;
+  JsonFrozenValue operator[](int index) const;
+
+  // bytes held by the document
+  std::size_t memoryUsage() const;
+
+private:
+  // values keep pointing to the data when the document is moved
+  std::unique_ptr<detail::FrozenData> data_;
+};
+
+} // suger
+
+#endif //SUGERJSON_JSONFROZEN_HPP
@@ -0,0 +1,36 @@
+// Copyright (c) 2023. SugerSalt
+
+#ifndef SUGERJSON_JSONHANDLER_HPP
+#define SUGERJSON_JSONHANDLER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace suger {
+
+// Receives the events of JsonReader::parse without building a JsonValue tree.
+// Every callback returns whether parsing should go on, returning false stops the reader
+// and makes parse return false. Strings are only valid during the callback.
+// Members of an object arrive as onKey followed by the events of the value.
+class JsonHandler {
+public:
+  virtual ~JsonHandler() = default;
+
+  virtual bool onNull() { return true; }
+  virtual bool onBool(bool) { return true; }
+  // integers that fit into int, like JsonType::Int
+  virtual bool onInt(int) { return true; }
+  virtual bool onInt64(int64_t) { return true; }
+  virtual bool onDouble(double) { return true; }
+  virtual bool onString(const std::string &) { return true; }
+  virtual bool onStartObject() { return true; }
+  virtual bool onKey(const std::string &) { return true; }
+  virtual bool onEndObject(std::size_t /* member_count */) { return true; }
+  virtual bool onStartArray() { return true; }
+  virtual bool onEndArray(std::size_t /* element_count */) { return true; }
+};
+
+} // suger
+
+#endif //SUGERJSON_JSONHANDLER_HPP
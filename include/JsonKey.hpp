@@ -0,0 +1,64 @@
+// Copyright (c) 2023. SugerSalt
+
+#ifndef SUGERJSON_JSONKEY_HPP
+#define SUGERJSON_JSONKEY_HPP
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include "JsonArena.hpp"
+
+namespace suger {
+
+namespace detail {
+
+// a key stored once by the key table of a JsonDocument
+struct InternedKey {
+  std::size_t hash;
+  std::string str;
+};
+
+} // detail
+
+// The name of an object member. Keys read into a JsonDocument with key interning point to the
+// single copy kept by the document, which also knows their hash. Copies always own their name.
+class JsonKey {
+public:
+  JsonKey() : shared_(nullptr), own_() {}
+  JsonKey(std::string str) : shared_(nullptr), own_(std::move(str)) {}
+  explicit JsonKey(const detail::InternedKey *shared) : shared_(shared), own_() {}
+  JsonKey(const JsonKey &other) : shared_(nullptr), own_(other.str()) {}
+  JsonKey(JsonKey &&other) noexcept = default;
+  JsonKey &operator=(const JsonKey &other) {
+    if (this != &other) {
+      own_ = other.str();
+      shared_ = nullptr;
+    }
+    return *this;
+  }
+  JsonKey &operator=(JsonKey &&other) noexcept = default;
+
+  const std::string &str() const {
+    return shared_ != nullptr ? shared_->str : own_;
+  }
+  std::size_t hash() const {
+    return shared_ != nullptr ? shared_->hash : std::hash<std::string>()(own_);
+  }
+  // compares the interned copies first
+  bool operator==(const JsonKey &other) const {
+    return (shared_ != nullptr && shared_ == other.shared_) || str() == other.str();
+  }
+  // the name is kept in heap memory of its own
+  bool usesHeap() const {
+    return shared_ == nullptr && detail::usesHeap(own_);
+  }
+
+private:
+  const detail::InternedKey *shared_;
+  std::string own_;
+};
+
+} // suger
+
+#endif //SUGERJSON_JSONKEY_HPP
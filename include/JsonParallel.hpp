@@ -0,0 +1,50 @@
+// Copyright (c) 2023. SugerSalt
+
+#ifndef SUGERJSON_JSONPARALLEL_HPP
+#define SUGERJSON_JSONPARALLEL_HPP
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "JsonValue.hpp"
+
+namespace suger {
+
+// Receives each document with its offset in the input. It is called concurrently from the worker
+// threads and in no particular order.
+using JsonLineCallback = std::function<void(std::size_t offset, JsonValue &json)>;
+
+// Parse JSON Lines input on several threads, all cores when threads is 0. The input is split into
+// chunks at line breaks which the threads take one by one, so a document may not span lines.
+// On invalid input the first parse_error is thrown once all threads stopped, its row is the line
+// in the whole input.
+std::vector<JsonValue> parseLinesParallel(const char *data, std::size_t length,
+                                          unsigned threads = 0);
+std::vector<JsonValue> parseLinesParallel(const std::string &data, unsigned threads = 0);
+void parseLinesParallel(const char *data, std::size_t length, const JsonLineCallback &callback,
+                        unsigned threads = 0);
+void parseLinesParallel(const std::string &data, const JsonLineCallback &callback,
+                        unsigned threads = 0);
+// the file is mapped into memory like JsonReader::parseFile does
+std::vector<JsonValue> parseFileLinesParallel(const std::string &path, unsigned threads = 0);
+void parseFileLinesParallel(const std::string &path, const JsonLineCallback &callback,
+                            unsigned threads = 0);
+
+// values of a subtree handled by one task of copyParallel and dumpParallel
+const std::size_t kParallelGrain = 1 << 14;
+
+// Copy or write a large tree on several threads, all cores when threads is 0. The tree is split
+// into subtrees of about grain values, large arrays and objects are split by their members.
+// Trees of up to grain values are handled on the calling thread like the copy constructor and
+// toString. The result is the same as theirs.
+JsonValue copyParallel(const JsonValue &value, unsigned threads = 0,
+                       std::size_t grain = kParallelGrain);
+std::string toStringParallel(const JsonValue &value, unsigned threads = 0,
+                             std::size_t grain = kParallelGrain);
+// append the json text to out, every task writes into a buffer of its own which are joined
+void dumpParallel(const JsonValue &value, std::string &out, unsigned threads = 0,
+                  std::size_t grain = kParallelGrain);
+
+} // suger
+
+#endif //SUGERJSON_JSONPARALLEL_HPP
@@ -0,0 +1,144 @@
+// Copyright (c) 2023. SugerSalt
+
+#ifndef SUGERJSON_JSONPUSHPARSER_HPP
+#define SUGERJSON_JSONPUSHPARSER_HPP
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include "JsonHandler.hpp"
+#include "JsonValue.hpp"
+
+namespace suger {
+
+namespace detail {
+class ValueStack;
+} // detail
+
+// Parses json which arrives in chunks of any size, e.g. from a socket. The state is kept between
+// calls to feed, so values can be split anywhere. Any number of values may follow each other,
+// separated by optional whitespace. Errors are reported like JsonReader does.
+class JsonPushParser {
+public:
+  // complete values are collected and taken with takeValue
+  JsonPushParser();
+  // the events go to handler, which has to outlive the parser
+  explicit JsonPushParser(JsonHandler &handler);
+  JsonPushParser(const JsonPushParser &) = delete;
+  JsonPushParser &operator=(const JsonPushParser &) = delete;
+  ~JsonPushParser();
+
+  // how a key which is already in its object is handled, only used when values are collected
+  void setDuplicateKeyPolicy(DuplicateKeyPolicy policy);
+  DuplicateKeyPolicy duplicateKeyPolicy() const;
+  // keep arrays of one kind of number or booleans packed, on by default
+  void setPackedArrays(bool enable);
+  bool packedArrays() const;
+
+  // Parse the next chunk and return how many values it completed.
+  // Throws parse_error on invalid json, the parser has to be reset after that.
+  std::size_t feed(const char *data, std::size_t length);
+  std::size_t feed(const std::string &data);
+  // The input has ended. A number at the very end is completed, an unfinished value
+  // throws parse_error.
+  std::size_t finish();
+  // the handler stopped parsing, the rest of the input is ignored
+  bool stopped() const;
+  // a value has been started but not completed yet
+  bool inValue() const;
+
+  bool hasValue() const;
+  // the oldest complete value which was not taken yet, null if there is none
+  JsonValue takeValue();
+  // start a new input, values which were not taken are dropped
+  void reset();
+
+private:
+  class Builder;
+
+  enum State {
+    Idle,          // between values
+    Value,         // after ':' or ','
+    FirstElement,  // after '['
+    NextElement,   // after an element
+    FirstKey,      // after '{'
+    Key,           // after ',' in an object
+    Colon,         // after a key
+    NextMember,    // after a member
+    InString,
+    InNumber,
+    InLiteral
+  };
+  enum NumberPart {
+    NumberSign,
+    NumberInt,
+    NumberFrac,
+    NumberExp,
+    NumberExpDigits
+  };
+  struct Frame {
+    bool object;
+    std::size_t count;
+  };
+
+  JsonHandler *handler_;
+  std::unique_ptr<Builder> builder_;
+  std::deque<JsonValue> values_;
+
+  State state_;
+  std::vector<Frame> frames_;
+  bool stopped_;
+  std::size_t completed_;
+  // string being read, escape_ when its last character was '\\'
+  std::string str_;
+  bool is_key_;
+  bool escape_;
+  // number being read when it continues in the next chunk
+  std::string number_;
+  NumberPart number_part_;
+  const char *literal_;
+  std::size_t literal_len_;
+  std::size_t matched_;
+
+  // positions are offsets into the whole input, a new line can only be a blank or escaped
+  const char *chunk_;
+  int64_t chunk_offset_;
+  int64_t row_;
+  int64_t line_begin_;
+  int64_t token_row_;
+  int64_t token_col_;
+  // position after the last key, and after each key still waiting for its object
+  int64_t key_end_;
+  std::vector<std::pair<int64_t, int64_t>> key_pos_;
+
+  template<class Handler>
+  void parse(Handler &handler, const char *pos, const char *end);
+  template<class Handler>
+  const char *beginValue(Handler &handler, const char *pos);
+  template<class Handler>
+  const char *readString(Handler &handler, const char *pos, const char *end);
+  template<class Handler>
+  const char *readNumber(Handler &handler, const char *pos, const char *end);
+  template<class Handler>
+  void endNumber(Handler &handler, const char *begin, const char *end);
+  template<class Handler>
+  const char *readLiteral(Handler &handler, const char *pos, const char *end);
+  template<class Handler>
+  void endContainer(Handler &handler);
+  void endValue();
+  void emit(bool go_on);
+  const char *skipBlank(const char *pos, const char *end);
+  void newLine(const char *pos);
+  void beginToken(const char *pos);
+  int64_t offset(const char *pos) const;
+  const char *expected() const;
+  void throwParseError(const std::string &msg, int64_t row, int64_t col) const;
+  void throwParseError(const char *msg, int64_t pos) const;
+  void throwTokenError(const char *msg) const;
+};
+
+} // suger
+
+#endif //SUGERJSON_JSONPUSHPARSER_HPP
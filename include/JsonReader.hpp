@@ -4,21 +4,86 @@
 #define SUGERJSON_JSONREADER_HPP
 
 #include <istream>
+#include <memory>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+#include "JsonDocument.hpp"
+#include "JsonHandler.hpp"
 #include "JsonValue.hpp"
 
 namespace suger {
 
+namespace detail {
+class LineWorker;
+class StructuralIndex;
+} // detail
+
 class JsonReader {
+  friend class JsonStreamReader;
+  friend class JsonView;
+  friend class detail::LineWorker;
+
 public:
   JsonReader();
+  ~JsonReader();
+
+  // Find the tokens of the whole document with SIMD first and build the tree from their
+  // positions after that. Pays off for large documents with many strings or much whitespace,
+  // the result and the errors are the same. Off by default.
+  void setStructuralIndex(bool enable);
+  bool structuralIndex() const;
+  // How a key which is already in its object is handled when building a JsonValue, rejected by
+  // default. A JsonHandler is given every key.
+  void setDuplicateKeyPolicy(DuplicateKeyPolicy policy);
+  DuplicateKeyPolicy duplicateKeyPolicy() const;
+  // Keep arrays of only booleans, only integers or only doubles packed, see
+  // JsonValue::isPacked. On by default.
+  void setPackedArrays(bool enable);
+  bool packedArrays() const;
 
+  // Documents given by string or pointer are parsed in place without being copied.
+  // They only have to stay valid during the call, the parsed JsonValue owns all of its data.
   JsonValue parse(const std::string &document);
+  JsonValue parse(const char *document);
+  JsonValue parse(const char *document, std::size_t length);
   JsonValue parse(std::istream &in);
   bool parse(const std::string &document, JsonValue &json);
+  bool parse(const char *document, JsonValue &json);
+  bool parse(const char *document, std::size_t length, JsonValue &json);
   bool parse(std::istream &in, JsonValue &json);
-
+  // The file is mapped into memory and parsed without going through a stream.
+  JsonValue parseFile(const std::string &path);
+  bool parseFile(const std::string &path, JsonValue &json);
+  // All values are allocated from the arena of doc, the previous content of doc is released.
+  bool parse(const std::string &document, JsonDocument &doc);
+  bool parse(const char *document, JsonDocument &doc);
+  bool parse(const char *document, std::size_t length, JsonDocument &doc);
+  bool parseFile(const std::string &path, JsonDocument &doc);
+  // Only reports the events to handler, no JsonValue is built.
+  bool parse(const std::string &document, JsonHandler &handler);
+  bool parse(const char *document, JsonHandler &handler);
+  bool parse(const char *document, std::size_t length, JsonHandler &handler);
+  bool parse(std::istream &in, JsonHandler &handler);
+  bool parseFile(const std::string &path, JsonHandler &handler);
+#if __cplusplus >= 201703L
+  JsonValue parse(std::string_view document) {
+    return parse(document.data(), document.size());
+  }
+  bool parse(std::string_view document, JsonValue &json) {
+    return parse(document.data(), document.size(), json);
+  }
+  bool parse(std::string_view document, JsonDocument &doc) {
+    return parse(document.data(), document.size(), doc);
+  }
+  bool parse(std::string_view document, JsonHandler &handler) {
+    return parse(document.data(), document.size(), handler);
+  }
+#endif
 
 private:
+  class DomBuilder;
+
   enum TokenType {
     BeginOfStream,
     EndOfStream,
@@ -37,22 +102,38 @@ private:
     Error
   };
   TokenType token_;
+  const char *begin_;
   const char *pos_;
   const char *end_;
-  int64_t col_pos_;
-  int64_t row_pos_;
+  // the input ended in the middle of the value
+  bool at_end_;
+  // values waiting for their array or object, and where their keys were read
+  std::unique_ptr<detail::ValueStack> stack_;
+  std::vector<const char *> key_pos_;
+  // set while the structural index is used
+  std::unique_ptr<detail::StructuralIndex> index_;
+  bool use_index_;
+  // strings and keys are read into this buffer
+  std::string str_;
 
   std::string doc_;
 
+  void reset(const char *begin, const char *end);
   TokenType getNextToken();
   void ignoreBlank();
-  bool readValue(JsonValue &json);
-  bool readObject(JsonValue &json);
-  bool readArray(JsonValue &json);
-  bool readString(JsonValue &json);
-  bool readNumber(JsonValue &json);
+  void readDom(JsonValue &json);
+  void readDocument(JsonDocument &doc);
+  // the same descent drives a JsonHandler and the DomBuilder
+  template<class Handler>
+  bool readValue(Handler &handler);
+  template<class Handler>
+  bool readObject(Handler &handler);
+  template<class Handler>
+  bool readArray(Handler &handler);
+  template<class Handler>
+  bool readNumber(Handler &handler);
 
-  std::string getString();
+  void getString(std::string &str);
   bool strMatch(const char *pattern, int len);
   void throwParseError(const char *msg) const;
 };
@@ -0,0 +1,58 @@
+// Copyright (c) 2023. SugerSalt
+
+#ifndef SUGERJSON_JSONSNAPSHOT_HPP
+#define SUGERJSON_JSONSNAPSHOT_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "JsonValue.hpp"
+
+namespace suger {
+
+class JsonReader;
+
+// Holds the current version of a document which is replaced as a whole, e.g. a configuration
+// reloaded while it is read. Readers take the current version without locking and keep using
+// it for as long as they hold it, a new version does not change the one they have. Writers
+// are serialized and wait only for readers which are just taking the old version.
+class JsonSnapshot {
+public:
+  // holds a null value
+  JsonSnapshot();
+  explicit JsonSnapshot(JsonValue value);
+  JsonSnapshot(const JsonSnapshot &) = delete;
+  JsonSnapshot &operator=(const JsonSnapshot &) = delete;
+  ~JsonSnapshot();
+
+  // the current version, never null
+  std::shared_ptr<const JsonValue> load() const;
+  // incremented by every store
+  uint64_t version() const;
+
+  // publish a new version, value must not be null
+  void store(JsonValue value);
+  void store(std::shared_ptr<const JsonValue> value);
+  // parse and publish the result, the current version is kept if parsing throws
+  void reload(const std::string &document);
+  void reload(const std::string &document, JsonReader &reader);
+  void reloadFile(const std::string &path);
+  void reloadFile(const std::string &path, JsonReader &reader);
+
+private:
+  using Version = std::shared_ptr<const JsonValue>;
+
+  std::atomic<const Version *> current_;
+  // readers register in the counter of the epoch they saw, a writer flips the epoch and waits
+  // until the counter of the previous one drops to zero before deleting the old version
+  std::atomic<uint32_t> epoch_;
+  mutable std::atomic<std::size_t> readers_[2];
+  std::atomic<uint64_t> version_;
+  std::mutex writer_;
+};
+
+} // suger
+
+#endif //SUGERJSON_JSONSNAPSHOT_HPP
@@ -0,0 +1,37 @@
+// Copyright (c) 2023. SugerSalt
+
+#ifndef SUGERJSON_JSONSPAN_HPP
+#define SUGERJSON_JSONSPAN_HPP
+
+#include <cstddef>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+
+namespace suger {
+
+// read only view of contiguous elements, like std::span<const T>
+template<class T>
+class JsonSpan {
+public:
+  JsonSpan() : data_(nullptr), size_(0) {}
+  JsonSpan(const T *data, std::size_t size) : data_(data), size_(size) {}
+
+  const T *data() const { return data_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const T *begin() const { return data_; }
+  const T *end() const { return data_ + size_; }
+  const T &operator[](std::size_t pos) const { return data_[pos]; }
+#if __cplusplus >= 202002L
+  operator std::span<const T>() const { return std::span<const T>(data_, size_); }
+#endif
+
+private:
+  const T *data_;
+  std::size_t size_;
+};
+
+} // suger
+
+#endif //SUGERJSON_JSONSPAN_HPP
@@ -0,0 +1,54 @@
+// Copyright (c) 2023. SugerSalt
+
+#ifndef SUGERJSON_JSONSTREAMREADER_HPP
+#define SUGERJSON_JSONSTREAMREADER_HPP
+
+#include <istream>
+#include <string>
+#include "JsonDocument.hpp"
+#include "JsonReader.hpp"
+#include "JsonValue.hpp"
+
+namespace suger {
+
+// Reads the documents of a stream one after another, e.g. JSON Lines or json values written
+// back to back, separated by optional whitespace. The read buffer, the reader and, when
+// reading into the same JsonDocument, the arena are reused for every document.
+// Rows and columns of parse errors are counted from the start of the failing document.
+class JsonStreamReader {
+public:
+  static const std::size_t kDefaultBufferSize = 1 << 16;
+
+  // The stream is read in blocks of buffer_size, a longer document grows the buffer.
+  explicit JsonStreamReader(std::istream &in, std::size_t buffer_size = kDefaultBufferSize);
+  // The documents are parsed in place, data has to stay valid while reading.
+  JsonStreamReader(const char *data, std::size_t length);
+  explicit JsonStreamReader(const std::string &data);
+  JsonStreamReader(const JsonStreamReader &) = delete;
+  JsonStreamReader &operator=(const JsonStreamReader &) = delete;
+
+  // Read the next document, false when only whitespace is left.
+  bool next(JsonValue &json);
+  // The previous content of doc is released and its memory reused.
+  bool next(JsonDocument &doc);
+  // documents read so far
+  std::size_t count() const;
+
+private:
+  std::istream *in_;
+  std::string buffer_;
+  const char *pos_;
+  const char *end_;
+  bool eof_;
+  std::size_t count_;
+  JsonReader reader_;
+
+  template<class Read>
+  bool readNext(Read read);
+  // keep [pos_, end_) and append what the stream has
+  void refill();
+};
+
+} // suger
+
+#endif //SUGERJSON_JSONSTREAMREADER_HPP
@@ -16,5 +16,13 @@ enum class JsonType {
   Object
 };
 
+// what parsing into a JsonValue does with a key which is already in its object
+enum class DuplicateKeyPolicy {
+  Reject,     // throw parse_error
+  LastWins,   // the later value replaces the earlier one, the key keeps its first position
+  FirstWins,  // the later value is dropped
+  KeepAll     // every member is kept, lookups find the first one
+};
+
 } // suger
 #endif //SUGERJSON_JSONTYPE_HPP
@@ -3,18 +3,39 @@
 #ifndef SUGERJSON_JSONVALUE_HPP
 #define SUGERJSON_JSONVALUE_HPP
 
+#include <ostream>
+#include <string>
 #include <vector>
-#include <unordered_map>
+#include "JsonArena.hpp"
 #include "JsonBase.hpp"
+#include "JsonKey.hpp"
+#include "JsonSpan.hpp"
 
 namespace suger {
 
+class JsonValue;
 class JsonIterator;
 class JsonConstIterator;
+class JsonReader;
+class JsonFrozen;
+namespace detail {
+class ValueStack;
+class ParallelTree;
+class Freezer;
+class JsonObject;
+} // detail
+
+// containers inside the tree, their memory comes from the arena of a JsonDocument or the heap
+using JsonList = std::vector<JsonValue, JsonAllocator<JsonValue>>;
+using JsonKeyList = std::vector<JsonKey, JsonAllocator<JsonKey>>;
 
 class JsonValue {
   friend class JsonIterator;
   friend class JsonConstIterator;
+  friend class JsonReader;
+  friend class detail::ValueStack;
+  friend class detail::ParallelTree;
+  friend class detail::Freezer;
 
 public:
   JsonValue();
@@ -39,10 +60,11 @@ public:
   JsonValue(const std::initializer_list<const char *> &value);
   JsonValue(const JsonValue &other);
   JsonValue(JsonValue &&other) noexcept;
+  ~JsonValue();
   JsonValue &operator=(const JsonValue &value);
   JsonValue &operator=(JsonValue &&value) noexcept;
 
-  void swap(JsonValue &other);
+  void swap(JsonValue &other) noexcept;
   JsonType getType() const;
 
   bool isNull() const;
@@ -60,9 +82,32 @@ public:
   int64_t asLong() const;
   double asDouble() const;
   const std::string &asString() const;
-  const std::vector<JsonValue> &asArray() const;
+  const JsonList &asArray() const;
   const JsonValue &asObject() const;
 
+  // Arrays of only booleans, only integers or only doubles can be packed into contiguous
+  // memory. pack() returns false if the array is not of one kind. Read only access keeps an
+  // array packed, changing it or taking non-const references unpacks it.
+  bool isPacked() const;
+  // Boolean, Int, Long or Double for a packed array, Null for any other value
+  JsonType packedType() const;
+  bool pack();
+  // the elements of a packed array of integers, doubles or booleans, empty for an empty array
+  JsonSpan<int64_t> asInt64Span() const;
+  JsonSpan<double> asDoubleSpan() const;
+  JsonSpan<bool> asBoolSpan() const;
+
+  // Let copies of this value share its strings, arrays and objects, all the way down, instead
+  // of copying them. A shared array or object is copied, one level at a time, by the first
+  // change through operator[], push_back, insert, erase or another non-const access, so a copy
+  // costs O(1) until it is changed. An array or object which handed out a non-const reference or
+  // iterator is no longer shared, later copies copy it, so the reference cannot change them.
+  // Nodes which are shared already and values in a JsonDocument are left as they are.
+  void share();
+  bool isShareable() const;
+  // an immutable copy for concurrent readers, JsonFrozen.hpp has to be included to use it
+  JsonFrozen freeze() const;
+
   operator bool() const;
   operator int() const;
   operator int64_t() const;
@@ -103,14 +148,33 @@ public:
   bool removeMember(const std::string &key);
 
   std::string toString() const;
+  // append the json text to out, reusing its capacity
+  void dump(std::string &out) const;
   std::ostream &toDumpStream(std::ostream &out) const;
   friend std::ostream &operator<<(std::ostream &out, const JsonValue &value);
 private:
+  // null, bool and numbers are stored inline, only string, array and object use the heap
   JsonType type_;
-  JsonBase::UniquePtr data_;
+  union {
+    bool b;
+    int i;
+    int64_t i64;
+    double d;
+    JsonBase *ptr;
+  } data_;
+
+  // used by JsonReader, a null arena means the heap
+  JsonValue(JsonType type, JsonArena *arena);
+  JsonValue(std::string &&value, JsonArena *arena);
 
   void setToObject();
   void setToArray();
+  void release();
+  // give the value a node of its own before it is changed
+  void detach();
+  // detach before a non-const reference into the node is handed out, and stop sharing the node
+  void leak();
+  JsonBase *cloneNode() const;
 };
 
 class JsonIterator : public std::iterator<std::forward_iterator_tag, JsonValue> {
@@ -120,8 +184,8 @@ class JsonIterator : public std::iterator<std::forward_iterator_tag, JsonValue>
 public:
   explicit JsonIterator(JsonType type);
   explicit JsonIterator(JsonValue &value);
-  explicit JsonIterator(const std::vector<JsonValue>::iterator &value);
-  explicit JsonIterator(const std::unordered_map<std::string, JsonValue>::iterator &value);
+  explicit JsonIterator(const JsonList::iterator &value);
+  JsonIterator(detail::JsonObject &object, std::size_t pos);
   JsonIterator(const JsonIterator &other);
   JsonIterator(JsonIterator &&other) noexcept;
   JsonIterator &operator=(const JsonIterator &other);
@@ -140,8 +204,10 @@ public:
 private:
   JsonType type_;
   JsonValue *value_;
-  std::vector<JsonValue>::iterator array_iter_;
-  std::unordered_map<std::string, JsonValue>::iterator object_iter_;
+  JsonList::iterator array_iter_;
+  // object members are walked by position
+  detail::JsonObject *object_;
+  std::size_t pos_;
 };
 
 class JsonConstIterator : public std::iterator<std::forward_iterator_tag, JsonValue> {
@@ -150,9 +216,8 @@ class JsonConstIterator : public std::iterator<std::forward_iterator_tag, JsonVa
 public:
   explicit JsonConstIterator(JsonType type);
   explicit JsonConstIterator(const JsonValue &value);
-  explicit JsonConstIterator(const std::vector<JsonValue>::const_iterator &value);
-  explicit JsonConstIterator(
-    const std::unordered_map<std::string, JsonValue>::const_iterator &value);
+  explicit JsonConstIterator(const JsonList::const_iterator &value);
+  JsonConstIterator(const detail::JsonObject &object, std::size_t pos);
   JsonConstIterator(const JsonConstIterator &other);
   JsonConstIterator(const JsonIterator &other);
   JsonConstIterator(JsonConstIterator &&other) noexcept;
@@ -173,8 +238,9 @@ public:
 private:
   JsonType type_;
   const JsonValue *value_;
-  std::vector<JsonValue>::const_iterator array_iter_;
-  std::unordered_map<std::string, JsonValue>::const_iterator object_iter_;
+  JsonList::const_iterator array_iter_;
+  const detail::JsonObject *object_;
+  std::size_t pos_;
 };
 
 } // suger
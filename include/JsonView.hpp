@@ -0,0 +1,86 @@
+// Copyright (c) 2023. SugerSalt
+
+#ifndef SUGERJSON_JSONVIEW_HPP
+#define SUGERJSON_JSONVIEW_HPP
+
+#include <cstdint>
+#include <string>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+#include "JsonType.hpp"
+#include "JsonValue.hpp"
+
+namespace suger {
+
+namespace detail {
+struct ParsedNumber;
+} // detail
+
+// Reads a document without building a JsonValue for it. A view only points into the text,
+// looking up a member or element scans its object or array from the start and steps over the
+// other values by matching brackets, so only what is read is ever parsed.
+// Values which are stepped over are not checked, errors in them may go unnoticed. A value which
+// is read has to be followed by ',', '}', ']' or the end of the text. The first of duplicate
+// keys is found. The text has to stay valid while views of it are used.
+class JsonView {
+public:
+  explicit JsonView(const char *text);
+  JsonView(const char *text, std::size_t length);
+  explicit JsonView(const std::string &text);
+#if __cplusplus >= 201703L
+  explicit JsonView(std::string_view text) : JsonView(text.data(), text.size()) {}
+#endif
+
+  JsonType getType() const;
+  bool isNull() const;
+  bool isBoolean() const;
+  bool isNumber() const;
+  bool isInt() const;
+  bool isLong() const;
+  bool isDouble() const;
+  bool isString() const;
+  bool isArray() const;
+  bool isObject() const;
+
+  bool asBoolean() const;
+  int asInt() const;
+  int64_t asLong() const;
+  double asDouble() const;
+  std::string asString() const;
+
+  // throw key_error when there is no such member or element
+  JsonView operator[](const std::string &key) const;
+  JsonView operator[](const char *key) const;
+  JsonView operator[](std::size_t index) const;
+  JsonView operator[](int index) const;
+  bool isMember(const std::string &key) const;
+  // number of members or elements, 0 for the other types
+  std::size_t size() const;
+
+  // the text of the value as written in the document
+  std::string text() const;
+  // parse the whole value
+  JsonValue toValue() const;
+
+private:
+  // begin_ is the start of the document, errors are reported relative to it
+  const char *begin_;
+  const char *pos_;
+  const char *end_;
+
+  JsonView(const char *begin, const char *pos, const char *end);
+  bool readNumber(detail::ParsedNumber &number) const;
+  const char *findMember(const char *key, std::size_t length) const;
+  const char *findElement(std::size_t index) const;
+  // the first member or element, nullptr if there is none
+  const char *firstItem() const;
+  // the member or element after the value at pos, nullptr after the last one
+  const char *nextItem(const char *pos) const;
+  // read the key at pos and return where its value starts, match tells if it is key
+  const char *readKey(const char *pos, const char *key, std::size_t length, bool &match) const;
+};
+
+} // suger
+
+#endif //SUGERJSON_JSONVIEW_HPP
@@ -10,17 +10,29 @@
 namespace suger {
 namespace detail {
 
+// Arrays of only booleans, only integers or only doubles can be packed: the numbers are kept
+// contiguous and the JsonValue elements are built when they are first asked for. Read only
+// access builds them once beside the packed store, any other access turns the array back into
+// a list of JsonValue.
 class JsonArray : public JsonBase {
 public:
-  using JsonList = std::vector<JsonValue>;
+  using JsonList = suger::JsonList;
+
+  // the reader packs arrays from this size on
+  static const std::size_t kMinPackedSize = 8;
 
   JsonArray();
-  JsonArray(const JsonList &value);
+  explicit JsonArray(JsonArena *arena);
+  JsonArray(const std::vector<JsonValue> &value);
   JsonArray(const std::vector<bool> &value);
   JsonArray(const std::vector<int> &value);
   JsonArray(const std::vector<int64_t> &value);
   JsonArray(const std::vector<double> &value);
   JsonArray(const std::vector<std::string> &value);
+  // copies are always allocated on the heap
+  JsonArray(const JsonArray &other);
+  JsonArray &operator=(const JsonArray &) = delete;
+  ~JsonArray() override;
 
   const JsonList &getValue() const;
   JsonList & getRef();
@@ -48,10 +60,31 @@ public:
 
   void swap(JsonArray &other);
 
+  // Pack the array, or keep the count values of an array being built packed. Returns false if
+  // the values are not of one kind, the array is left unchanged then.
+  bool pack();
+  bool pack(const JsonValue *values, std::size_t count);
+  bool isPacked() const;
+  // Boolean, Int, Long or Double. Int arrays may hold numbers out of the range of int, their
+  // elements are Long then, like the ones of the reader.
+  JsonType packedType() const;
+  // int64_t, double or bool elements
+  const void *packedData() const;
+
   std::string toString() const override;
-  std::ostream &toDumpStream(std::ostream &out) const override;
+  void dump(std::string &out) const override;
 private:
-  std::vector<JsonValue> data_;
+  struct Packed;
+
+  JsonList data_;
+  Packed *packed_;
+
+  const JsonList &expanded() const;
+  void unpack();
+  bool pushPacked(const JsonValue &value);
+  Packed *createPacked(JsonType type, std::size_t capacity) const;
+  void releasePacked(Packed *packed) const;
+  void dumpPacked(std::string &out) const;
 };
 } // suger
 } // detail
@@ -3,8 +3,6 @@
 #ifndef SUGERJSON_JSONIMP_HPP
 #define SUGERJSON_JSONIMP_HPP
 
-#include "JsonBool.hpp"
-#include "JsonNumber.hpp"
 #include "JsonString.hpp"
 #include "JsonArray.hpp"
 #include "JsonObject.hpp"
@@ -3,48 +3,99 @@
 #ifndef SUGERJSON_JSONOBJECT_HPP
 #define SUGERJSON_JSONOBJECT_HPP
 
-#include <unordered_map>
+#include <cstdint>
+#include <vector>
 #include "../JsonBase.hpp"
 #include "../JsonValue.hpp"
+#include "ValueChunks.hpp"
 
 namespace suger {
 namespace detail {
 
+// Members are kept in insertion order, the keys in a vector and the values in chunks which an
+// append never moves, so a reference to a member stays valid while members are added. Small
+// objects are searched linearly, a hash index over the keys is only built once the object grows
+// past kIndexThreshold.
+// An object may use the keys and index of another object with the same keys instead of its own,
+// it takes a copy of them before it is changed.
 class JsonObject : public JsonBase{
 public:
-  using ObjectList = std::unordered_map<std::string, JsonValue>;
-  
+  using KeyList = JsonKeyList;
+  using ValueList = ValueChunks;
+  using IndexList = std::vector<uint32_t, JsonAllocator<uint32_t>>;
+
+  static const std::size_t kIndexThreshold = 16;
+
   JsonObject();
+  explicit JsonObject(JsonArena *arena);
+  // the copy owns its keys and lives on the heap
+  JsonObject(const JsonObject &other);
+  JsonObject &operator=(const JsonObject &) = delete;
 
-  const ObjectList &getValue() const;
-  ObjectList &getRef();
-  void setValue(const ObjectList &x);
+  const KeyList &getKeys() const;
+  const ValueList &getValues() const;
+  ValueList &getValuesRef();
 
   std::size_t size() const;
   bool empty() const;
 
-  ObjectList::iterator begin();
-  ObjectList::const_iterator begin() const;
-  ObjectList::iterator end();
-  ObjectList::const_iterator end() const;
-
   void clear();
+  void reserve(std::size_t n);
   bool insert(const std::string &key, const JsonValue &value);
   bool insert(const std::string &key, JsonValue &&value);
-  ObjectList::iterator erase(ObjectList::const_iterator pos);
+  // key is only moved from if it is inserted
+  bool insert(std::string &&key, JsonValue &&value);
+  // Position of key, which is appended with a null value if it does not exist yet. The key is
+  // hashed and probed once, and only moved from if it is appended.
+  std::size_t findOrAppend(const std::string &key, bool &appended);
+  std::size_t findOrAppend(JsonKey &&key, bool &appended);
+  // append even if key exists, find returns the first of equal keys
+  void insertMulti(JsonKey &&key, JsonValue &&value);
+  // Use the keys of shape, which has to outlive this object and stay unchanged, and move the
+  // values for them from values. The object has to be empty.
+  void share(const JsonObject &shape, JsonValue *values);
+  // the object uses the keys of another one
+  bool shared() const;
+  // Take a copy of the keys and index of other with null values, which are filled in later.
+  // The object has to be empty, the values are then contiguous in one chunk.
+  void copyKeys(const JsonObject &other);
+  // the members after pos move down
+  void erase(std::size_t pos);
   std::size_t erase(const std::string &key);
 
   JsonValue &operator[](const std::string &key);
   const JsonValue &operator[](const std::string &key) const;
 
   void swap(JsonObject &other);
-  ObjectList::iterator find(const std::string &key);
-  ObjectList::const_iterator find(const std::string &key) const;
+  // position of key, size() if it does not exist
+  std::size_t find(const std::string &key) const;
 
   std::string toString() const override;
-  std::ostream &toDumpStream(std::ostream &out) const override;
+  void dump(std::string &out) const override;
 private:
-  ObjectList data_;
+  // keys_ and index_ are those of shape_ while it is set
+  const JsonObject *shape_;
+  KeyList keys_;
+  ValueList values_;
+  // open addressing table of position + 1, 0 marks an empty slot
+  IndexList index_;
+  // a key with heap memory is owned by this arena object, the arena clears the keys on reset
+  bool keys_cleanup_;
+
+  const KeyList &keys() const;
+  const IndexList &index() const;
+  void unshare();
+  template<class Key>
+  std::size_t probe(Key &&key, bool &appended);
+  void append(JsonKey key);
+  void pushMember(JsonKey key);
+  void addToIndex(std::size_t pos);
+  // index for count keys, none while count is below the threshold
+  void rebuildIndex(std::size_t count);
+  void addKeysCleanup();
+  // addKeysCleanup if one of keys_ keeps its characters on the heap
+  void checkKeysCleanup();
+  static void destroyKeys(void *object);
 };
 
 } // suger
@@ -13,13 +13,14 @@ public:
   JsonString();
   JsonString(const std::string &value);
   JsonString(const char *value);
+  explicit JsonString(std::string &&value, bool in_arena = false);
 
   const std::string &getValue() const;
   std::string &getRef();
   void setValue(const std::string &x);
 
   std::string toString() const override;
-  std::ostream &toDumpStream(std::ostream &out) const override;
+  void dump(std::string &out) const override;
 private:
   std::string data_;
 };
@@ -0,0 +1,38 @@
+// Copyright (c) 2023. SugerSalt
+
+#ifndef SUGERJSON_KEYTABLE_HPP
+#define SUGERJSON_KEYTABLE_HPP
+
+#include <deque>
+#include <string>
+#include <vector>
+#include "../JsonKey.hpp"
+
+namespace suger {
+namespace detail {
+
+// The interned keys of a JsonDocument. Every distinct key is stored once together with its
+// hash, and stays at the same address until the table is cleared.
+class KeyTable {
+public:
+  // the document drops the table when it is reset with more keys than this
+  static const std::size_t kMaxKeys = 1 << 16;
+
+  KeyTable();
+
+  const InternedKey *intern(const std::string &key);
+  void clear();
+  std::size_t size() const;
+
+private:
+  std::deque<InternedKey> keys_;
+  // open addressing table, nullptr marks an empty slot
+  std::vector<const InternedKey *> index_;
+
+  void grow();
+};
+
+} // detail
+} // suger
+
+#endif //SUGERJSON_KEYTABLE_HPP
@@ -0,0 +1,34 @@
+// Copyright (c) 2023. SugerSalt
+
+#ifndef SUGERJSON_MAPPEDFILE_HPP
+#define SUGERJSON_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace suger {
+namespace detail {
+
+// The content of a file, mapped into memory where the system supports it and read otherwise.
+// Throws parse_error when the file can not be read.
+class MappedFile {
+public:
+  explicit MappedFile(const std::string &path);
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  ~MappedFile();
+
+  const char *data() const;
+  std::size_t size() const;
+
+private:
+  const char *data_;
+  std::size_t size_;
+  // the content when the file is not mapped
+  std::string content_;
+};
+
+} // detail
+} // suger
+
+#endif //SUGERJSON_MAPPEDFILE_HPP
@@ -0,0 +1,54 @@
+// Copyright (c) 2023. SugerSalt
+
+#ifndef SUGERJSON_STRUCTURALINDEX_HPP
+#define SUGERJSON_STRUCTURALINDEX_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace suger {
+namespace detail {
+
+// Positions of the tokens of a document, found 64 characters at a time with classifyBlock.
+// Indexed are structural characters and quotes outside of strings, the first character of
+// every other run outside of strings, and backslashes and control characters inside strings.
+// Strings are told apart by counting unescaped quotes, which matches the reader as long as the
+// document is valid up to the position asked for. The document is indexed a window at a time,
+// so the index stays small and in cache.
+class StructuralIndex {
+public:
+  StructuralIndex();
+
+  void reset(const char *begin, const char *end);
+  // first indexed position at or after pos, end if there is none
+  const char *next(const char *pos) {
+    while (cur_ != last_ && window_ + *cur_ < pos) {
+      ++cur_;
+    }
+    return cur_ != last_ ? window_ + *cur_ : nextWindow(pos);
+  }
+
+private:
+  std::vector<uint32_t> offsets_;
+  const uint32_t *cur_;
+  const uint32_t *last_;
+  // offsets are relative to the window
+  const char *window_;
+  // the document is indexed up to indexed_
+  const char *indexed_;
+  const char *end_;
+  // carried from one block to the next: the first character is escaped, inside a string,
+  // after a character of a run
+  uint64_t escaped_;
+  uint64_t in_string_;
+  uint64_t in_run_;
+
+  const char *nextWindow(const char *pos);
+  void indexWindow();
+  uint32_t *indexBlock(const char *block, uint32_t offset, uint32_t *out);
+};
+
+} // detail
+} // suger
+
+#endif //SUGERJSON_STRUCTURALINDEX_HPP
@@ -0,0 +1,69 @@
+// Copyright (c) 2023. SugerSalt
+
+#ifndef SUGERJSON_VALUECHUNKS_HPP
+#define SUGERJSON_VALUECHUNKS_HPP
+
+#include <vector>
+#include "../JsonArena.hpp"
+#include "../JsonValue.hpp"
+
+namespace suger {
+namespace detail {
+
+// A list of values which an append never moves, so references to them stay valid while the
+// list grows. The first chunk holds as many values as were reserved before the first append,
+// every further chunk twice as many as the one before it. Erase moves the values after the
+// erased one down.
+class ValueChunks {
+public:
+  using allocator_type = JsonAllocator<JsonValue>;
+
+  // chunk size of a list which was not reserved for
+  static const std::size_t kFirstChunk = 4;
+
+  explicit ValueChunks(const allocator_type &alloc = allocator_type());
+  // the copy is one chunk on the heap
+  ValueChunks(const ValueChunks &other);
+  ValueChunks &operator=(const ValueChunks &) = delete;
+  ~ValueChunks();
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  std::size_t capacity() const;
+
+  JsonValue &operator[](std::size_t pos) {
+    return pos < first_capacity_ ? first_[pos] : locate(pos);
+  }
+  const JsonValue &operator[](std::size_t pos) const {
+    return pos < first_capacity_ ? first_[pos] : locate(pos);
+  }
+  JsonValue &back() { return (*this)[size_ - 1]; }
+
+  void reserve(std::size_t n);
+  void push_back(JsonValue &&value);
+  // append n values moved from values
+  void append(JsonValue *values, std::size_t n);
+  // append null values up to size n
+  void resize(std::size_t n);
+  void erase(std::size_t pos);
+  // the chunks are kept
+  void clear();
+  void swap(ValueChunks &other) noexcept;
+
+private:
+  using ChunkList = std::vector<JsonValue *, JsonAllocator<JsonValue *>>;
+
+  JsonValue *first_;
+  std::size_t first_capacity_;
+  std::size_t size_;
+  // the chunks after the first one
+  ChunkList more_;
+
+  JsonValue &locate(std::size_t pos) const;
+  void addChunk(std::size_t n);
+};
+
+} // suger
+} // detail
+
+#endif //SUGERJSON_VALUECHUNKS_HPP
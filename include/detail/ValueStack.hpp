@@ -0,0 +1,76 @@
+// Copyright (c) 2023. SugerSalt
+
+#ifndef SUGERJSON_VALUESTACK_HPP
+#define SUGERJSON_VALUESTACK_HPP
+
+#include <string>
+#include <vector>
+#include "../JsonValue.hpp"
+
+namespace suger {
+namespace detail {
+
+class JsonObject;
+class KeyTable;
+
+// Builds a JsonValue tree from parse events. The members of the arrays and objects being parsed
+// wait here until their container is complete, so every container is allocated once with its
+// final size. Values are allocated from arena, or the heap when it is null.
+// In an arena, an object with the same keys in the same order as one of the last objects
+// built shares their keys and index, e.g. the records of a table.
+class ValueStack {
+public:
+  // number of recently built objects whose keys are offered to the next ones
+  static const std::size_t kShapeCache = 8;
+
+  ValueStack();
+
+  void setArena(JsonArena *arena);
+  void setDuplicateKeyPolicy(DuplicateKeyPolicy policy);
+  DuplicateKeyPolicy duplicateKeyPolicy() const;
+  // keys are interned into table unless it is null
+  void setKeyTable(KeyTable *table);
+  // pack arrays of one kind of number or booleans, see JsonArray
+  void setPackedArrays(bool enable);
+  bool packedArrays() const;
+  void clear();
+  std::size_t size() const;
+
+  template<class T>
+  void push(T value) {
+    values_.emplace_back(value);
+  }
+  void pushNull();
+  // value is moved from, and key too when it is not interned
+  void pushString(std::string &value);
+  void pushKey(std::string &key);
+
+  // Replace the last count keys and values with an object. Returns false if a key repeats while
+  // duplicates are rejected, the index of the repeated key is stored in duplicate and the stack
+  // has to be cleared.
+  bool endObject(std::size_t count, std::size_t &duplicate);
+  void endArray(std::size_t count);
+  std::size_t keyCount() const;
+  const std::string &key(std::size_t index) const;
+
+  JsonValue pop();
+
+private:
+  JsonArena *arena_;
+  DuplicateKeyPolicy policy_;
+  KeyTable *key_table_;
+  bool packed_arrays_;
+  std::vector<JsonValue> values_;
+  std::vector<JsonKey> keys_;
+  // objects of the current arena whose keys can be shared, replaced in turn
+  const JsonObject *shapes_[kShapeCache];
+  std::size_t next_shape_;
+
+  bool shareKeys(JsonObject &object, std::size_t count);
+  void clearShapes();
+};
+
+} // detail
+} // suger
+
+#endif //SUGERJSON_VALUESTACK_HPP
@@ -0,0 +1,45 @@
+// Copyright (c) 2023. SugerSalt
+
+#ifndef SUGERJSON_NUMBER_HPP
+#define SUGERJSON_NUMBER_HPP
+
+#include <cstdint>
+#include "../JsonType.hpp"
+
+namespace suger {
+namespace detail {
+
+// Convert the unsigned decimal text [begin, end) whose value is mantissa * 10^exponent.
+// mantissa is only exact when significant <= 19, otherwise the text itself is converted.
+// The result is always the correctly rounded double.
+double parseDouble(const char *begin, const char *end, uint64_t mantissa, int significant,
+                   int64_t exponent);
+
+// A json number, Int when it fits into int, Long when it is an integer that fits into int64_t
+// and Double otherwise.
+struct ParsedNumber {
+  JsonType type;
+  union {
+    int i;
+    int64_t i64;
+    double d;
+  };
+};
+
+// Read the number starting at pos, which must be a digit, '-' or '+'. Returns the position
+// after the number.
+const char *scanNumber(const char *pos, const char *end, ParsedNumber &number);
+
+// enough for any value written by writeInt64 or writeDouble
+const int kNumberBufferSize = 32;
+
+// Write x into buf and return the number of characters, buf is not terminated.
+int writeInt64(int64_t x, char *buf);
+// Write the shortest text which parses back to exactly x, always keeping a '.' or an exponent
+// so that it is read back as a double. Infinity and NaN are not valid json and become null.
+int writeDouble(double x, char *buf);
+
+} // detail
+} // suger
+
+#endif //SUGERJSON_NUMBER_HPP
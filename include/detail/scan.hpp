@@ -0,0 +1,32 @@
+// Copyright (c) 2023. SugerSalt
+
+#ifndef SUGERJSON_SCAN_HPP
+#define SUGERJSON_SCAN_HPP
+
+#include <cstdint>
+
+namespace suger {
+namespace detail {
+
+// One bit per character of a 64 byte block, bit i is the character at i.
+struct BlockMasks {
+  uint64_t quote;
+  uint64_t backslash;
+  uint64_t blank;
+  // { } [ ] : ,
+  uint64_t structural;
+  // characters below 0x20
+  uint64_t control;
+};
+
+// first position in [pos, end) which is not ' ', '\t', '\r' or '\n', end if none
+const char *skipBlank(const char *pos, const char *end);
+// first position in [pos, end) which is '"', '\\' or a control character, end if none
+const char *findStringSpecial(const char *pos, const char *end);
+// classify the 64 characters at block
+void classifyBlock(const char *block, BlockMasks &masks);
+
+} // detail
+} // suger
+
+#endif //SUGERJSON_SCAN_HPP
@@ -3,15 +3,34 @@
 #ifndef SUGERJSON_TOOL_HPP
 #define SUGERJSON_TOOL_HPP
 
-#include <ostream>
+#include <string>
 
 namespace suger{
 
 std::string addTranslatedChar(const std::string &str);
-std::ostream &addTranslatedChar(const std::string &str, std::ostream &out);
-
-
+// append str to out, escaping the characters which can not appear in a json string as is
+void addTranslatedChar(const std::string &str, std::string &out);
+// the character meant by the escape sequence '\\' followed by ch
+inline char getTranslatedChar(char ch) {
+  switch (ch) {
+    case 'b':
+      return '\b';
+    case 'f':
+      return '\f';
+    case 'n':
+      return '\n';
+    case 'r':
+      return '\r';
+    case 't':
+      return '\t';
+    default:
+      return ch;
+  }
+}
+
+// Throw parse_error with msg and the row and column of pos, counted from begin.
+[[noreturn]] void throwParseError(const std::string &msg, const char *begin, const char *pos);
 
 }  // suger
 
-#endif //SUGERJSON_TOOL_HPP
+#endif //SUGERJSON_TOOL_HPP
\ No newline at end of file
@@ -0,0 +1,102 @@
+// Copyright (c) 2023. SugerSalt
+
+#include "JsonArena.hpp"
+#include <algorithm>
+
+namespace suger {
+
+namespace {
+
+const std::size_t kHeaderSize = (sizeof(void *) * 2 + alignof(std::max_align_t) - 1) /
+                                alignof(std::max_align_t) * alignof(std::max_align_t);
+
+} // namespace
+
+const std::size_t JsonArena::kDefaultBlockSize;
+const std::size_t JsonArena::kMaxBlockSize;
+
+JsonArena::JsonArena(std::size_t block_size)
+    : head_(nullptr), pos_(nullptr), end_(nullptr),
+      block_size_(std::max<std::size_t>(block_size, kHeaderSize * 2)), cleanups_() {
+
+}
+
+JsonArena::~JsonArena() {
+  runCleanups();
+  while (head_ != nullptr) {
+    Block *next = head_->next;
+    ::operator delete(head_);
+    head_ = next;
+  }
+}
+
+void JsonArena::addCleanup(void *object, void (*destroy)(void *)) {
+  cleanups_.push_back({object, destroy});
+}
+
+void JsonArena::reset() {
+  runCleanups();
+  Block *largest = head_;
+  for (Block *block = head_; block != nullptr; block = block->next) {
+    if (block->size > largest->size) {
+      largest = block;
+    }
+  }
+  while (head_ != nullptr) {
+    Block *next = head_->next;
+    if (head_ != largest) {
+      ::operator delete(head_);
+    }
+    head_ = next;
+  }
+  if (largest != nullptr) {
+    largest->next = nullptr;
+    head_ = largest;
+    pos_ = reinterpret_cast<char *>(largest) + kHeaderSize;
+    end_ = reinterpret_cast<char *>(largest) + largest->size;
+  }
+}
+
+std::size_t JsonArena::capacity() const {
+  std::size_t total = 0;
+  for (Block *block = head_; block != nullptr; block = block->next) {
+    total += block->size;
+  }
+  return total;
+}
+
+void *JsonArena::allocateSlow(std::size_t size, std::size_t align) {
+  std::size_t needed = kHeaderSize + size + align;
+  if (needed > block_size_) {
+    // a dedicated block, so the rest of the current block is not wasted
+    auto block = static_cast<Block *>(::operator new(needed));
+    block->size = needed;
+    if (head_ == nullptr) {
+      block->next = nullptr;
+      head_ = block;
+    } else {
+      block->next = head_->next;
+      head_->next = block;
+    }
+    auto pos = reinterpret_cast<uintptr_t>(block) + kHeaderSize;
+    pos = (pos + align - 1) & ~(uintptr_t(align) - 1);
+    return reinterpret_cast<void *>(pos);
+  }
+  auto block = static_cast<Block *>(::operator new(block_size_));
+  block->size = block_size_;
+  block->next = head_;
+  head_ = block;
+  pos_ = reinterpret_cast<char *>(block) + kHeaderSize;
+  end_ = reinterpret_cast<char *>(block) + block_size_;
+  block_size_ = std::min(block_size_ * 2, std::max(block_size_, kMaxBlockSize));
+  return allocate(size, align);
+}
+
+void JsonArena::runCleanups() {
+  for (auto it = cleanups_.rbegin(); it != cleanups_.rend(); ++it) {
+    it->destroy(it->object);
+  }
+  cleanups_.clear();
+}
+
+} // suger
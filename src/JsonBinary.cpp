@@ -0,0 +1,689 @@
+// Copyright (c) 2023. SugerSalt
+
+#include "JsonBinary.hpp"
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include "JsonError.hpp"
+#include "detail/ValueStack.hpp"
+
+namespace suger {
+
+namespace {
+
+// the initial byte followed by bytes bytes of x
+void putHead(std::string &out, unsigned initial, uint64_t x, int bytes) {
+  char buf[9];
+  buf[0] = static_cast<char>(initial);
+  for (int i = bytes; i > 0; --i) {
+    buf[i] = static_cast<char>(x & 0xff);
+    x >>= 8;
+  }
+  out.append(buf, static_cast<std::size_t>(bytes) + 1);
+}
+
+void putByte(std::string &out, unsigned byte) {
+  out += static_cast<char>(byte);
+}
+
+// d is written as a float when that loses nothing
+bool fitsFloat(double d) {
+  return std::fabs(d) <= FLT_MAX && static_cast<double>(static_cast<float>(d)) == d;
+}
+
+uint32_t floatBits(float f) {
+  uint32_t bits;
+  std::memcpy(&bits, &f, sizeof(bits));
+  return bits;
+}
+
+uint64_t doubleBits(double d) {
+  uint64_t bits;
+  std::memcpy(&bits, &d, sizeof(bits));
+  return bits;
+}
+
+struct Cbor {
+  static void head(std::string &out, unsigned major, uint64_t n) {
+    unsigned type = major << 5;
+    if (n < 24) {
+      putByte(out, type | static_cast<unsigned>(n));
+    } else if (n <= 0xff) {
+      putHead(out, type | 24, n, 1);
+    } else if (n <= 0xffff) {
+      putHead(out, type | 25, n, 2);
+    } else if (n <= 0xffffffff) {
+      putHead(out, type | 26, n, 4);
+    } else {
+      putHead(out, type | 27, n, 8);
+    }
+  }
+  static void null(std::string &out) {
+    putByte(out, 0xf6);
+  }
+  static void boolean(std::string &out, bool b) {
+    putByte(out, b ? 0xf5 : 0xf4);
+  }
+  static void integer(std::string &out, int64_t x) {
+    // a negative x is stored as -1 - x
+    if (x >= 0) {
+      head(out, 0, static_cast<uint64_t>(x));
+    } else {
+      head(out, 1, ~static_cast<uint64_t>(x));
+    }
+  }
+  static void real(std::string &out, double d) {
+    if (fitsFloat(d)) {
+      putHead(out, 0xfa, floatBits(static_cast<float>(d)), 4);
+    } else {
+      putHead(out, 0xfb, doubleBits(d), 8);
+    }
+  }
+  static void string(std::string &out, const std::string &str) {
+    head(out, 3, str.size());
+    out += str;
+  }
+  static void array(std::string &out, std::size_t size) {
+    head(out, 4, size);
+  }
+  static void object(std::string &out, std::size_t size) {
+    head(out, 5, size);
+  }
+};
+
+struct MessagePack {
+  // fix holds sizes below limit, larger ones take 1 (if format8 is not 0), 2 or 4 bytes
+  static void head(std::string &out, uint64_t n, unsigned fix, uint64_t limit,
+                   unsigned format8, unsigned format16, unsigned format32) {
+    if (n < limit) {
+      putByte(out, fix | static_cast<unsigned>(n));
+    } else if (format8 != 0 && n <= 0xff) {
+      putHead(out, format8, n, 1);
+    } else if (n <= 0xffff) {
+      putHead(out, format16, n, 2);
+    } else if (n <= 0xffffffff) {
+      putHead(out, format32, n, 4);
+    } else {
+      throw std::length_error("MessagePack: too many elements or bytes");
+    }
+  }
+  static void null(std::string &out) {
+    putByte(out, 0xc0);
+  }
+  static void boolean(std::string &out, bool b) {
+    putByte(out, b ? 0xc3 : 0xc2);
+  }
+  static void integer(std::string &out, int64_t x) {
+    auto bits = static_cast<uint64_t>(x);
+    if (x >= -32 && x < 128) {
+      putByte(out, static_cast<unsigned>(bits & 0xff));
+    } else if (x > 0) {
+      int bytes = x <= 0xff ? 1 : x <= 0xffff ? 2 : x <= 0xffffffff ? 4 : 8;
+      putHead(out, bytes == 1 ? 0xcc : bytes == 2 ? 0xcd : bytes == 4 ? 0xce : 0xcf, bits, bytes);
+    } else {
+      int bytes = x >= INT8_MIN ? 1 : x >= INT16_MIN ? 2 : x >= INT32_MIN ? 4 : 8;
+      putHead(out, bytes == 1 ? 0xd0 : bytes == 2 ? 0xd1 : bytes == 4 ? 0xd2 : 0xd3, bits, bytes);
+    }
+  }
+  static void real(std::string &out, double d) {
+    if (fitsFloat(d)) {
+      putHead(out, 0xca, floatBits(static_cast<float>(d)), 4);
+    } else {
+      putHead(out, 0xcb, doubleBits(d), 8);
+    }
+  }
+  static void string(std::string &out, const std::string &str) {
+    head(out, str.size(), 0xa0, 32, 0xd9, 0xda, 0xdb);
+    out += str;
+  }
+  static void array(std::string &out, std::size_t size) {
+    head(out, size, 0x90, 16, 0, 0xdc, 0xdd);
+  }
+  static void object(std::string &out, std::size_t size) {
+    head(out, size, 0x80, 16, 0, 0xde, 0xdf);
+  }
+};
+
+template<class Format>
+void encode(const JsonValue &value, std::string &out) {
+  switch (value.getType()) {
+    case JsonType::Null:
+      Format::null(out);
+      break;
+    case JsonType::Boolean:
+      Format::boolean(out, value.asBoolean());
+      break;
+    case JsonType::Int:
+    case JsonType::Long:
+      Format::integer(out, value.asLong());
+      break;
+    case JsonType::Double:
+      Format::real(out, value.asDouble());
+      break;
+    case JsonType::String:
+      Format::string(out, value.asString());
+      break;
+    case JsonType::Array:
+      Format::array(out, value.size());
+      // packed elements are read in place instead of through the expanded values
+      switch (value.packedType()) {
+        case JsonType::Boolean:
+          for (bool b: value.asBoolSpan()) {
+            Format::boolean(out, b);
+          }
+          break;
+        case JsonType::Int:
+        case JsonType::Long:
+          for (int64_t x: value.asInt64Span()) {
+            Format::integer(out, x);
+          }
+          break;
+        case JsonType::Double:
+          for (double d: value.asDoubleSpan()) {
+            Format::real(out, d);
+          }
+          break;
+        default:
+          for (const auto &element: value) {
+            encode<Format>(element, out);
+          }
+          break;
+      }
+      break;
+    case JsonType::Object:
+      Format::object(out, value.size());
+      for (auto it = value.begin(), end = value.end(); it != end; ++it) {
+        Format::string(out, it.key());
+        encode<Format>(it.value(), out);
+      }
+      break;
+  }
+}
+
+double halfToDouble(unsigned half) {
+  unsigned exponent = (half >> 10) & 0x1f;
+  unsigned mantissa = half & 0x3ff;
+  double d;
+  if (exponent == 0) {
+    d = std::ldexp(mantissa, -24);
+  } else if (exponent != 31) {
+    d = std::ldexp(mantissa + 1024, static_cast<int>(exponent) - 25);
+  } else {
+    d = mantissa == 0 ? HUGE_VAL : NAN;
+  }
+  return half & 0x8000 ? -d : d;
+}
+
+// Builds the value on a ValueStack while the containers being read wait in frames_,
+// so deep nesting does not recurse.
+class Decoder {
+public:
+  Decoder(detail::ValueStack &stack, const char *data, std::size_t length)
+      : stack_(stack), begin_(reinterpret_cast<const uint8_t *>(data)), pos_(begin_),
+        end_(begin_ + length), done_(false) {}
+
+protected:
+  struct Frame {
+    bool object;
+    // ended by a break instead of a size
+    bool indefinite;
+    // an object waits for a key rather than a value
+    bool key;
+    uint64_t size;
+    uint64_t count;
+  };
+
+  detail::ValueStack &stack_;
+  const uint8_t *begin_;
+  const uint8_t *pos_;
+  const uint8_t *end_;
+  bool done_;
+  std::vector<Frame> frames_;
+  // offsets of the keys of the objects being read
+  std::vector<std::size_t> key_pos_;
+  std::string str_;
+
+  [[noreturn]] void fail(const std::string &msg, const uint8_t *pos) const {
+    throw parse_error("Syntax error: " + msg + " At byte: " + std::to_string(pos - begin_));
+  }
+
+  void need(uint64_t bytes) const {
+    if (bytes > static_cast<uint64_t>(end_ - pos_)) {
+      fail("incomplete data.", end_);
+    }
+  }
+
+  uint64_t readBigEndian(int bytes) {
+    need(bytes);
+    uint64_t x = 0;
+    for (int i = 0; i < bytes; ++i) {
+      x = x << 8 | *pos_++;
+    }
+    return x;
+  }
+
+  float readFloat() {
+    auto bits = static_cast<uint32_t>(readBigEndian(4));
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+  }
+
+  double readDouble() {
+    uint64_t bits = readBigEndian(8);
+    double d;
+    std::memcpy(&d, &bits, sizeof(d));
+    return d;
+  }
+
+  JsonValue finish() {
+    if (pos_ != end_) {
+      fail("unexpected data after the value.", pos_);
+    }
+    return stack_.pop();
+  }
+
+  void notKey(const uint8_t *item) const {
+    if (!frames_.empty() && frames_.back().object && frames_.back().key) {
+      fail("key should be a string.", item);
+    }
+  }
+
+  template<class T>
+  void scalar(T value, const uint8_t *item) {
+    notKey(item);
+    stack_.push(value);
+    valueDone();
+  }
+
+  void null(const uint8_t *item) {
+    notKey(item);
+    stack_.pushNull();
+    valueDone();
+  }
+
+  // integers are Int or Long by their range, like the numbers of JsonReader
+  void signedInteger(int64_t x, const uint8_t *item) {
+    if (x >= INT32_MIN && x <= INT32_MAX) {
+      scalar(static_cast<int>(x), item);
+    } else {
+      scalar(x, item);
+    }
+  }
+
+  void unsignedInteger(uint64_t x, const uint8_t *item) {
+    if (x <= INT64_MAX) {
+      signedInteger(static_cast<int64_t>(x), item);
+    } else {
+      scalar(static_cast<double>(x), item);
+    }
+  }
+
+  // the value is -1 - x
+  void negativeInteger(uint64_t x, const uint8_t *item) {
+    if (x <= INT64_MAX) {
+      signedInteger(-1 - static_cast<int64_t>(x), item);
+    } else {
+      scalar(-1.0 - static_cast<double>(x), item);
+    }
+  }
+
+  // the content is in str_
+  void string(const uint8_t *item) {
+    if (!frames_.empty() && frames_.back().object && frames_.back().key) {
+      key_pos_.push_back(static_cast<std::size_t>(item - begin_));
+      stack_.pushKey(str_);
+      frames_.back().key = false;
+    } else {
+      stack_.pushString(str_);
+      valueDone();
+    }
+  }
+
+  void readString(uint64_t length) {
+    need(length);
+    str_.assign(reinterpret_cast<const char *>(pos_), static_cast<std::size_t>(length));
+    pos_ += length;
+  }
+
+  void startArray(uint64_t size, bool indefinite, const uint8_t *item) {
+    notKey(item);
+    frames_.push_back({false, indefinite, false, size, 0});
+    if (!indefinite && size == 0) {
+      endFrame();
+      valueDone();
+    }
+  }
+
+  void startObject(uint64_t size, bool indefinite, const uint8_t *item) {
+    notKey(item);
+    frames_.push_back({true, indefinite, true, size, 0});
+    if (!indefinite && size == 0) {
+      endFrame();
+      valueDone();
+    }
+  }
+
+  void endFrame() {
+    Frame frame = frames_.back();
+    frames_.pop_back();
+    auto count = static_cast<std::size_t>(frame.count);
+    if (frame.object) {
+      std::size_t duplicate;
+      if (!stack_.endObject(count, duplicate)) {
+        fail("Duplicate key \"" + stack_.key(duplicate) + "\".", begin_ + key_pos_[duplicate]);
+      }
+      key_pos_.resize(key_pos_.size() - count);
+    } else {
+      stack_.endArray(count);
+    }
+  }
+
+  // a value is complete, so are the containers it fills up
+  void valueDone() {
+    while (!frames_.empty()) {
+      Frame &frame = frames_.back();
+      ++frame.count;
+      frame.key = frame.object;
+      if (frame.indefinite || frame.count < frame.size) {
+        return;
+      }
+      endFrame();
+    }
+    done_ = true;
+  }
+};
+
+class CborDecoder : public Decoder {
+public:
+  using Decoder::Decoder;
+
+  JsonValue parse() {
+    while (!done_) {
+      need(1);
+      readItem();
+    }
+    return finish();
+  }
+
+private:
+  // the number which follows the initial byte
+  uint64_t argument(unsigned info, const uint8_t *item) {
+    if (info < 24) {
+      return info;
+    } else if (info <= 27) {
+      return readBigEndian(1 << (info - 24));
+    }
+    fail("invalid CBOR item.", item);
+  }
+
+  void readItem() {
+    const uint8_t *item = pos_;
+    unsigned initial = *pos_++;
+    unsigned major = initial >> 5;
+    unsigned info = initial & 0x1f;
+    if (major == 7) {
+      readSimple(info, item);
+      return;
+    }
+    if (info == 31) {
+      if (major == 2 || major == 3) {
+        readChunks(major, item);
+      } else if (major == 4) {
+        startArray(0, true, item);
+      } else if (major == 5) {
+        startObject(0, true, item);
+      } else {
+        fail("invalid CBOR item.", item);
+      }
+      return;
+    }
+    uint64_t arg = argument(info, item);
+    switch (major) {
+      case 0:
+        unsignedInteger(arg, item);
+        break;
+      case 1:
+        negativeInteger(arg, item);
+        break;
+      case 2:
+      case 3:
+        readString(arg);
+        string(item);
+        break;
+      case 4:
+        startArray(arg, false, item);
+        break;
+      case 5:
+        startObject(arg, false, item);
+        break;
+      default:
+        // a tag, the tagged item follows
+        break;
+    }
+  }
+
+  // an indefinite length string is a sequence of definite ones up to a break
+  void readChunks(unsigned major, const uint8_t *item) {
+    str_.clear();
+    while (true) {
+      need(1);
+      const uint8_t *chunk = pos_;
+      unsigned initial = *pos_++;
+      if (initial == 0xff) {
+        break;
+      }
+      if (initial >> 5 != major || (initial & 0x1f) == 31) {
+        fail("invalid chunk of indefinite length string.", chunk);
+      }
+      uint64_t length = argument(initial & 0x1f, chunk);
+      need(length);
+      str_.append(reinterpret_cast<const char *>(pos_), static_cast<std::size_t>(length));
+      pos_ += length;
+    }
+    string(item);
+  }
+
+  void readSimple(unsigned info, const uint8_t *item) {
+    switch (info) {
+      case 20:
+        scalar(false, item);
+        break;
+      case 21:
+        scalar(true, item);
+        break;
+      case 22:
+      case 23:
+        null(item);
+        break;
+      case 25:
+        scalar(halfToDouble(static_cast<unsigned>(readBigEndian(2))), item);
+        break;
+      case 26:
+        scalar(static_cast<double>(readFloat()), item);
+        break;
+      case 27:
+        scalar(readDouble(), item);
+        break;
+      case 31:
+        readBreak(item);
+        break;
+      default:
+        fail("unsupported CBOR simple value.", item);
+    }
+  }
+
+  void readBreak(const uint8_t *item) {
+    if (frames_.empty() || !frames_.back().indefinite ||
+        (frames_.back().object && !frames_.back().key)) {
+      fail("unexpected break.", item);
+    }
+    endFrame();
+    valueDone();
+  }
+};
+
+class MessagePackDecoder : public Decoder {
+public:
+  using Decoder::Decoder;
+
+  JsonValue parse() {
+    while (!done_) {
+      need(1);
+      readItem();
+    }
+    return finish();
+  }
+
+private:
+  void readItem() {
+    const uint8_t *item = pos_;
+    unsigned type = *pos_++;
+    if (type <= 0x7f) {
+      scalar(static_cast<int>(type), item);
+    } else if (type <= 0x8f) {
+      startObject(type & 0x0f, false, item);
+    } else if (type <= 0x9f) {
+      startArray(type & 0x0f, false, item);
+    } else if (type <= 0xbf) {
+      readString(type & 0x1f);
+      string(item);
+    } else if (type >= 0xe0) {
+      scalar(static_cast<int>(static_cast<int8_t>(type)), item);
+    } else {
+      readTyped(type, item);
+    }
+  }
+
+  void readTyped(unsigned type, const uint8_t *item) {
+    switch (type) {
+      case 0xc0:
+        null(item);
+        break;
+      case 0xc2:
+        scalar(false, item);
+        break;
+      case 0xc3:
+        scalar(true, item);
+        break;
+      case 0xc4:
+      case 0xd9:
+        readString(readBigEndian(1));
+        string(item);
+        break;
+      case 0xc5:
+      case 0xda:
+        readString(readBigEndian(2));
+        string(item);
+        break;
+      case 0xc6:
+      case 0xdb:
+        readString(readBigEndian(4));
+        string(item);
+        break;
+      case 0xca:
+        scalar(static_cast<double>(readFloat()), item);
+        break;
+      case 0xcb:
+        scalar(readDouble(), item);
+        break;
+      case 0xcc:
+      case 0xcd:
+      case 0xce:
+      case 0xcf:
+        unsignedInteger(readBigEndian(1 << (type - 0xcc)), item);
+        break;
+      case 0xd0:
+        signedInteger(static_cast<int8_t>(readBigEndian(1)), item);
+        break;
+      case 0xd1:
+        signedInteger(static_cast<int16_t>(readBigEndian(2)), item);
+        break;
+      case 0xd2:
+        signedInteger(static_cast<int32_t>(readBigEndian(4)), item);
+        break;
+      case 0xd3:
+        signedInteger(static_cast<int64_t>(readBigEndian(8)), item);
+        break;
+      case 0xdc:
+        startArray(readBigEndian(2), false, item);
+        break;
+      case 0xdd:
+        startArray(readBigEndian(4), false, item);
+        break;
+      case 0xde:
+        startObject(readBigEndian(2), false, item);
+        break;
+      case 0xdf:
+        startObject(readBigEndian(4), false, item);
+        break;
+      default:
+        fail("unsupported MessagePack type.", item);
+    }
+  }
+};
+
+} // namespace
+
+std::string toCbor(const JsonValue &value) {
+  std::string out;
+  dumpCbor(value, out);
+  return out;
+}
+
+void dumpCbor(const JsonValue &value, std::string &out) {
+  encode<Cbor>(value, out);
+}
+
+std::string toMessagePack(const JsonValue &value) {
+  std::string out;
+  dumpMessagePack(value, out);
+  return out;
+}
+
+void dumpMessagePack(const JsonValue &value, std::string &out) {
+  encode<MessagePack>(value, out);
+}
+
+JsonBinaryReader::JsonBinaryReader() : stack_(new detail::ValueStack()) {}
+
+JsonBinaryReader::~JsonBinaryReader() = default;
+
+void JsonBinaryReader::setDuplicateKeyPolicy(DuplicateKeyPolicy policy) {
+  stack_->setDuplicateKeyPolicy(policy);
+}
+
+DuplicateKeyPolicy JsonBinaryReader::duplicateKeyPolicy() const {
+  return stack_->duplicateKeyPolicy();
+}
+
+void JsonBinaryReader::setPackedArrays(bool enable) {
+  stack_->setPackedArrays(enable);
+}
+
+bool JsonBinaryReader::packedArrays() const {
+  return stack_->packedArrays();
+}
+
+JsonValue JsonBinaryReader::parseCbor(const std::string &data) {
+  return parseCbor(data.data(), data.size());
+}
+
+JsonValue JsonBinaryReader::parseCbor(const char *data, std::size_t length) {
+  stack_->clear();
+  return CborDecoder(*stack_, data, length).parse();
+}
+
+JsonValue JsonBinaryReader::parseMessagePack(const std::string &data) {
+  return parseMessagePack(data.data(), data.size());
+}
+
+JsonValue JsonBinaryReader::parseMessagePack(const char *data, std::size_t length) {
+  stack_->clear();
+  return MessagePackDecoder(*stack_, data, length).parse();
+}
+
+} // suger
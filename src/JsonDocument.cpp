@@ -0,0 +1,59 @@
+// Copyright (c) 2023. SugerSalt
+
+#include "JsonDocument.hpp"
+#include "detail/KeyTable.hpp"
+
+namespace suger {
+
+JsonDocument::JsonDocument(std::size_t block_size)
+    : keys_(), intern_keys_(false), arena_(block_size), root_() {
+
+}
+
+JsonDocument::~JsonDocument() = default;
+
+void JsonDocument::setKeyInterning(bool enable) {
+  if (enable && !keys_) {
+    keys_.reset(new detail::KeyTable());
+  }
+  intern_keys_ = enable;
+}
+
+bool JsonDocument::keyInterning() const {
+  return intern_keys_;
+}
+
+const JsonValue &JsonDocument::root() const {
+  return root_;
+}
+
+const JsonValue &JsonDocument::operator[](const std::string &key) const {
+  return root_[key];
+}
+
+const JsonValue &JsonDocument::operator[](const char *key) const {
+  return root_[key];
+}
+
+const JsonValue &JsonDocument::operator[](std::size_t index) const {
+  return root_[index];
+}
+
+const JsonValue &JsonDocument::operator[](int index) const {
+  return root_[index];
+}
+
+void JsonDocument::clear() {
+  root_.reset();
+  arena_.reset();
+  // nothing refers to the keys any more, keys which are not repeated should not pile up
+  if (keys_ && keys_->size() > detail::KeyTable::kMaxKeys) {
+    keys_->clear();
+  }
+}
+
+std::size_t JsonDocument::capacity() const {
+  return arena_.capacity();
+}
+
+} // suger
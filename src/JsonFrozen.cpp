@@ -0,0 +1,580 @@
+// Copyright (c) 2023. SugerSalt
+
+#include "JsonFrozen.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "JsonError.hpp"
+#include "detail/JsonImp.hpp"
+#include "detail/number.hpp"
+#include "detail/tool.hpp"
+
+namespace suger {
+namespace detail {
+
+// first is the position of a string in strings, of the first element in nodes or of the first
+// member in members
+struct FrozenNode {
+  JsonType type;
+  uint32_t size;
+  union {
+    bool b;
+    int i;
+    int64_t i64;
+    double d;
+    uint64_t first;
+  };
+};
+
+struct FrozenMember {
+  uint32_t key;
+  uint32_t value;
+};
+
+struct FrozenData {
+  std::vector<FrozenNode> nodes;
+  std::vector<FrozenMember> members;
+  // for every object the positions of its members sorted by key, next to its members
+  std::vector<uint32_t> order;
+  std::vector<std::string> strings;
+};
+
+// Lays out a JsonValue breadth first, so the children of every array and object get one block
+// of nodes, and builds JsonValue back from the nodes.
+class Freezer {
+public:
+  explicit Freezer(FrozenData &data) : data_(data) {}
+
+  void freeze(const JsonValue &root);
+  static JsonValue thaw(const FrozenData &data, uint32_t node);
+
+private:
+  FrozenData &data_;
+  // arrays and objects whose children are not laid out yet
+  std::vector<std::pair<const JsonValue *, uint32_t>> pending_;
+  // positions in strings by hash
+  std::unordered_multimap<std::size_t, uint32_t> strings_;
+
+  void place(const JsonValue &value, uint32_t node);
+  void placePacked(const JsonArray &array, uint32_t first);
+  void expand(const JsonValue &value, uint32_t node);
+  uint32_t intern(const std::string &str);
+  // used, after checking that count more nodes, members or strings can still be counted
+  static uint32_t reserve(std::size_t used, std::size_t count);
+};
+
+void Freezer::freeze(const JsonValue &root) {
+  data_.nodes.resize(1);
+  place(root, 0);
+  for (std::size_t i = 0; i < pending_.size(); ++i) {
+    expand(*pending_[i].first, pending_[i].second);
+  }
+  pending_.clear();
+  strings_.clear();
+}
+
+void Freezer::place(const JsonValue &value, uint32_t node) {
+  FrozenNode &out = data_.nodes[node];
+  out.type = value.type_;
+  out.size = 0;
+  out.first = 0;
+  switch (value.type_) {
+    case JsonType::Null:
+      break;
+    case JsonType::Boolean:
+      out.b = value.data_.b;
+      break;
+    case JsonType::Int:
+      out.i = value.data_.i;
+      break;
+    case JsonType::Long:
+      out.i64 = value.data_.i64;
+      break;
+    case JsonType::Double:
+      out.d = value.data_.d;
+      break;
+    case JsonType::String:
+      out.first = intern(static_cast<const JsonString *>(value.data_.ptr)->getValue());
+      break;
+    case JsonType::Array:
+    case JsonType::Object:
+      reserve(0, value.size());
+      out.size = static_cast<uint32_t>(value.size());
+      if (out.size != 0) {
+        pending_.emplace_back(&value, node);
+      }
+      break;
+  }
+}
+
+void Freezer::placePacked(const JsonArray &array, uint32_t first) {
+  const void *values = array.packedData();
+  for (std::size_t i = 0; i < array.size(); ++i) {
+    FrozenNode &out = data_.nodes[first + i];
+    out.size = 0;
+    out.first = 0;
+    switch (array.packedType()) {
+      case JsonType::Boolean:
+        out.type = JsonType::Boolean;
+        out.b = static_cast<const bool *>(values)[i];
+        break;
+      case JsonType::Double:
+        out.type = JsonType::Double;
+        out.d = static_cast<const double *>(values)[i];
+        break;
+      case JsonType::Int: {
+        int64_t number = static_cast<const int64_t *>(values)[i];
+        if (number >= INT_MIN && number <= INT_MAX) {
+          out.type = JsonType::Int;
+          out.i = static_cast<int>(number);
+        } else {
+          out.type = JsonType::Long;
+          out.i64 = number;
+        }
+        break;
+      }
+      default:
+        out.type = JsonType::Long;
+        out.i64 = static_cast<const int64_t *>(values)[i];
+        break;
+    }
+  }
+}
+
+void Freezer::expand(const JsonValue &value, uint32_t node) {
+  std::size_t count = data_.nodes[node].size;
+  uint32_t first = reserve(data_.nodes.size(), count);
+  data_.nodes.resize(first + count);
+  if (value.type_ == JsonType::Array) {
+    data_.nodes[node].first = first;
+    const auto &array = *static_cast<const JsonArray *>(value.data_.ptr);
+    if (array.isPacked()) {
+      placePacked(array, first);
+      return;
+    }
+    const JsonList &items = array.getValue();
+    for (std::size_t i = 0; i < count; ++i) {
+      place(items[i], static_cast<uint32_t>(first + i));
+    }
+    return;
+  }
+  const auto &object = *static_cast<const JsonObject *>(value.data_.ptr);
+  const JsonKeyList &keys = object.getKeys();
+  const JsonObject::ValueList &values = object.getValues();
+  std::size_t base = reserve(data_.members.size(), count);
+  data_.nodes[node].first = base;
+  for (std::size_t i = 0; i < count; ++i) {
+    data_.members.push_back({intern(keys[i].str()), static_cast<uint32_t>(first + i)});
+    data_.order.push_back(static_cast<uint32_t>(i));
+    place(values[i], static_cast<uint32_t>(first + i));
+  }
+  // equal keys stay in insertion order, so lookups find the first of them
+  const FrozenData &data = data_;
+  std::stable_sort(data_.order.begin() + static_cast<std::ptrdiff_t>(base), data_.order.end(),
+                   [&data, base](uint32_t lhs, uint32_t rhs) {
+    return data.strings[data.members[base + lhs].key] < data.strings[data.members[base + rhs].key];
+  });
+}
+
+uint32_t Freezer::intern(const std::string &str) {
+  std::size_t hash = std::hash<std::string>()(str);
+  auto range = strings_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (data_.strings[it->second] == str) {
+      return it->second;
+    }
+  }
+  uint32_t pos = reserve(data_.strings.size(), 1);
+  data_.strings.push_back(str);
+  strings_.emplace(hash, pos);
+  return pos;
+}
+
+uint32_t Freezer::reserve(std::size_t used, std::size_t count) {
+  if (used > UINT32_MAX || count > UINT32_MAX - used) {
+    throw std::length_error("JsonFrozen: too many values");
+  }
+  return static_cast<uint32_t>(used);
+}
+
+JsonValue Freezer::thaw(const FrozenData &data, uint32_t node) {
+  const FrozenNode &in = data.nodes[node];
+  switch (in.type) {
+    case JsonType::Null:
+      return JsonValue();
+    case JsonType::Boolean:
+      return JsonValue(in.b);
+    case JsonType::Int:
+      return JsonValue(in.i);
+    case JsonType::Long:
+      return JsonValue(in.i64);
+    case JsonType::Double:
+      return JsonValue(in.d);
+    case JsonType::String:
+      return JsonValue(data.strings[in.first]);
+    case JsonType::Array: {
+      JsonValue array(JsonType::Array);
+      auto &items = static_cast<JsonArray *>(array.data_.ptr)->getRef();
+      items.reserve(in.size);
+      for (uint32_t i = 0; i < in.size; ++i) {
+        items.push_back(thaw(data, static_cast<uint32_t>(in.first + i)));
+      }
+      return array;
+    }
+    case JsonType::Object: {
+      JsonValue object(JsonType::Object);
+      auto &members = *static_cast<JsonObject *>(object.data_.ptr);
+      members.reserve(in.size);
+      for (uint32_t i = 0; i < in.size; ++i) {
+        const FrozenMember &member = data.members[in.first + i];
+        members.insertMulti(JsonKey(data.strings[member.key]), thaw(data, member.value));
+      }
+      return object;
+    }
+  }
+  return JsonValue();
+}
+
+namespace {
+
+const FrozenData &nullData() {
+  static const FrozenData data = []() {
+    FrozenData null;
+    null.nodes.resize(1);
+    null.nodes[0].type = JsonType::Null;
+    null.nodes[0].size = 0;
+    null.nodes[0].first = 0;
+    return null;
+  }();
+  return data;
+}
+
+} // namespace
+
+} // detail
+
+using detail::FrozenData;
+using detail::FrozenMember;
+using detail::FrozenNode;
+
+JsonType JsonFrozenValue::getType() const {
+  return data_->nodes[node_].type;
+}
+
+bool JsonFrozenValue::isNull() const {
+  return getType() == JsonType::Null;
+}
+
+bool JsonFrozenValue::isBoolean() const {
+  return getType() == JsonType::Boolean;
+}
+
+bool JsonFrozenValue::isNumber() const {
+  return isInt() || isLong() || isDouble();
+}
+
+bool JsonFrozenValue::isInt() const {
+  return getType() == JsonType::Int;
+}
+
+bool JsonFrozenValue::isLong() const {
+  return getType() == JsonType::Long;
+}
+
+bool JsonFrozenValue::isDouble() const {
+  return getType() == JsonType::Double;
+}
+
+bool JsonFrozenValue::isString() const {
+  return getType() == JsonType::String;
+}
+
+bool JsonFrozenValue::isArray() const {
+  return getType() == JsonType::Array;
+}
+
+bool JsonFrozenValue::isObject() const {
+  return getType() == JsonType::Object;
+}
+
+bool JsonFrozenValue::asBoolean() const {
+  if (!isBoolean()) throw type_error(getType(), JsonType::Boolean);
+  return data_->nodes[node_].b;
+}
+
+int JsonFrozenValue::asInt() const {
+  if (!isInt()) throw type_error(getType(), JsonType::Int);
+  return data_->nodes[node_].i;
+}
+
+int64_t JsonFrozenValue::asLong() const {
+  if (isLong()) {
+    return data_->nodes[node_].i64;
+  } else if (isInt()) {
+    return data_->nodes[node_].i;
+  }
+  throw type_error(getType(), JsonType::Long);
+}
+
+double JsonFrozenValue::asDouble() const {
+  if (isDouble()) {
+    return data_->nodes[node_].d;
+  } else if (isInt()) {
+    return data_->nodes[node_].i;
+  }
+  throw type_error(getType(), JsonType::Double);
+}
+
+const std::string &JsonFrozenValue::asString() const {
+  if (!isString()) throw type_error(getType(), JsonType::String);
+  return data_->strings[data_->nodes[node_].first];
+}
+
+JsonFrozenValue JsonFrozenValue::operator[](const std::string &key) const {
+  if (!isObject()) throw type_error("operator[](std::string) can only be used by object type");
+  std::size_t pos = findMember(key.data(), key.size());
+  if (pos == size()) {
+    throw key_error(key);
+  }
+  return JsonFrozenValue(data_, data_->members[data_->nodes[node_].first + pos].value);
+}
+
+JsonFrozenValue JsonFrozenValue::operator[](const char *key) const {
+  if (!isObject()) throw type_error("operator[](char *) can only be used by object type");
+  std::size_t pos = findMember(key, std::strlen(key));
+  if (pos == size()) {
+    throw key_error(key);
+  }
+  return JsonFrozenValue(data_, data_->members[data_->nodes[node_].first + pos].value);
+}
+
+JsonFrozenValue JsonFrozenValue::operator[](std::size_t index) const {
+  if (!isArray()) throw type_error("operator[](std::size_t) can only be used by array type");
+  if (index >= size()) {
+    throw key_error(std::to_string(index));
+  }
+  return JsonFrozenValue(data_, static_cast<uint32_t>(data_->nodes[node_].first + index));
+}
+
+JsonFrozenValue JsonFrozenValue::operator[](int index) const {
+  if (!isArray()) throw type_error("operator[](int) can only be used by array type");
+  if (index < 0 || static_cast<std::size_t>(index) >= size()) {
+    throw key_error(std::to_string(index));
+  }
+  return JsonFrozenValue(data_, static_cast<uint32_t>(data_->nodes[node_].first + index));
+}
+
+std::size_t JsonFrozenValue::size() const {
+  return data_->nodes[node_].size;
+}
+
+bool JsonFrozenValue::empty() const {
+  if (!isArray() && !isObject()) {
+    throw type_error("empty() can only be used by array or object type");
+  }
+  return size() == 0;
+}
+
+JsonFrozenIterator JsonFrozenValue::begin() const {
+  return JsonFrozenIterator(*this, 0);
+}
+
+JsonFrozenIterator JsonFrozenValue::end() const {
+  return JsonFrozenIterator(*this, size());
+}
+
+JsonFrozenIterator JsonFrozenValue::find(const std::string &key) const {
+  if (!isObject()) throw type_error("find(std::string) can only be used by object type");
+  return JsonFrozenIterator(*this, findMember(key.data(), key.size()));
+}
+
+bool JsonFrozenValue::isMember(const std::string &key) const {
+  if (!isObject()) throw type_error("isMember(std::string) can only be used by object type");
+  return findMember(key.data(), key.size()) != size();
+}
+
+JsonFrozenIterator JsonFrozenValue::at(std::size_t index) const {
+  if (!isArray()) throw type_error("at(std::size_t) can only be used by array type");
+  return JsonFrozenIterator(*this, std::min(index, size()));
+}
+
+JsonValue JsonFrozenValue::toValue() const {
+  return detail::Freezer::thaw(*data_, node_);
+}
+
+std::string JsonFrozenValue::toString() const {
+  if (isString()) {
+    return asString();
+  }
+  std::string out;
+  dump(out);
+  return out;
+}
+
+void JsonFrozenValue::dump(std::string &out) const {
+  const FrozenNode &node = data_->nodes[node_];
+  char buf[detail::kNumberBufferSize];
+  switch (node.type) {
+    case JsonType::Null:
+      out.append("null", 4);
+      break;
+    case JsonType::Boolean:
+      if (node.b) {
+        out.append("true", 4);
+      } else {
+        out.append("false", 5);
+      }
+      break;
+    case JsonType::Int:
+      out.append(buf, detail::writeInt64(node.i, buf));
+      break;
+    case JsonType::Long:
+      out.append(buf, detail::writeInt64(node.i64, buf));
+      break;
+    case JsonType::Double:
+      out.append(buf, detail::writeDouble(node.d, buf));
+      break;
+    case JsonType::String:
+      out += '\"';
+      addTranslatedChar(data_->strings[node.first], out);
+      out += '\"';
+      break;
+    case JsonType::Array:
+      out += '[';
+      for (uint32_t i = 0; i < node.size; ++i) {
+        if (i != 0) {
+          out += ',';
+        }
+        JsonFrozenValue(data_, static_cast<uint32_t>(node.first + i)).dump(out);
+      }
+      out += ']';
+      break;
+    case JsonType::Object:
+      out += '{';
+      for (uint32_t i = 0; i < node.size; ++i) {
+        const FrozenMember &member = data_->members[node.first + i];
+        if (i != 0) {
+          out += ',';
+        }
+        out += '\"';
+        addTranslatedChar(data_->strings[member.key], out);
+        out += "\":";
+        JsonFrozenValue(data_, member.value).dump(out);
+      }
+      out += '}';
+      break;
+  }
+}
+
+std::size_t JsonFrozenValue::findMember(const char *key, std::size_t length) const {
+  const FrozenNode &node = data_->nodes[node_];
+  const uint32_t *order = data_->order.data() + node.first;
+  const FrozenMember *members = data_->members.data() + node.first;
+  std::size_t low = 0;
+  std::size_t high = node.size;
+  while (low < high) {
+    std::size_t mid = low + (high - low) / 2;
+    if (data_->strings[members[order[mid]].key].compare(0, std::string::npos, key, length) < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  if (low != node.size &&
+      data_->strings[members[order[low]].key].compare(0, std::string::npos, key, length) == 0) {
+    return order[low];
+  }
+  return node.size;
+}
+
+JsonFrozenIterator::JsonFrozenIterator(const JsonFrozenValue &parent, std::size_t pos)
+    : parent_(parent), pos_(pos), value_(parent) {
+  load();
+}
+
+JsonFrozenIterator &JsonFrozenIterator::operator++() {
+  ++pos_;
+  load();
+  return *this;
+}
+
+JsonFrozenIterator JsonFrozenIterator::operator++(int) {
+  JsonFrozenIterator old = *this;
+  ++*this;
+  return old;
+}
+
+void JsonFrozenIterator::load() {
+  if (pos_ >= parent_.size()) {
+    return;
+  }
+  const FrozenNode &node = parent_.data_->nodes[parent_.node_];
+  if (node.type == JsonType::Array) {
+    value_.node_ = static_cast<uint32_t>(node.first + pos_);
+  } else {
+    value_.node_ = parent_.data_->members[node.first + pos_].value;
+  }
+}
+
+const std::string &JsonFrozenIterator::key() const {
+  if (!parent_.isObject()) throw type_error("key() can only be used by object type");
+  const FrozenNode &node = parent_.data_->nodes[parent_.node_];
+  return parent_.data_->strings[parent_.data_->members[node.first + pos_].key];
+}
+
+JsonFrozen::JsonFrozen() : data_() {
+
+}
+
+JsonFrozen::JsonFrozen(const JsonValue &value) : data_(new FrozenData()) {
+  detail::Freezer(*data_).freeze(value);
+}
+
+JsonFrozen::JsonFrozen(JsonFrozen &&other) noexcept = default;
+
+JsonFrozen &JsonFrozen::operator=(JsonFrozen &&other) noexcept = default;
+
+JsonFrozen::~JsonFrozen() = default;
+
+JsonFrozenValue JsonFrozen::root() const {
+  return JsonFrozenValue(data_ ? data_.get() : &detail::nullData(), 0);
+}
+
+JsonFrozenValue JsonFrozen::operator[](const std::string &key) const {
+  return root()[key];
+}
+
+JsonFrozenValue JsonFrozen::operator[](const char *key) const {
+  return root()[key];
+}
+
+JsonFrozenValue JsonFrozen::operator[](std::size_t index) const {
+  return root()[index];
+}
+
+JsonFrozenValue JsonFrozen::operator[](int index) const {
+  return root()[index];
+}
+
+std::size_t JsonFrozen::memoryUsage() const {
+  if (!data_) {
+    return 0;
+  }
+  std::size_t total = sizeof(FrozenData) + data_->nodes.capacity() * sizeof(FrozenNode) +
+                      data_->members.capacity() * sizeof(FrozenMember) +
+                      data_->order.capacity() * sizeof(uint32_t) +
+                      data_->strings.capacity() * sizeof(std::string);
+  for (const auto &str: data_->strings) {
+    if (detail::usesHeap(str)) {
+      total += str.capacity() + 1;
+    }
+  }
+  return total;
+}
+
+} // suger
@@ -1,36 +1,39 @@
 // Copyright (c) 2023. SugerSalt
 
 #include "JsonValue.hpp"
+#include "detail/JsonObject.hpp"
 
 namespace suger {
-JsonIterator::JsonIterator(JsonType type) : type_(type), value_(nullptr) {
+JsonIterator::JsonIterator(JsonType type)
+  : type_(type), value_(nullptr), object_(nullptr), pos_(0) {
 
 }
 
-JsonIterator::JsonIterator(JsonValue &value) : type_(value.type_), value_(&value) {
+JsonIterator::JsonIterator(JsonValue &value)
+  : type_(value.type_), value_(&value), object_(nullptr), pos_(0) {
 
 }
 
-JsonIterator::JsonIterator(const std::vector<JsonValue>::iterator &value)
-  : type_(JsonType::Array), value_(nullptr), array_iter_(value) {
+JsonIterator::JsonIterator(const JsonList::iterator &value)
+  : type_(JsonType::Array), value_(nullptr), array_iter_(value), object_(nullptr), pos_(0) {
 
 }
 
-JsonIterator::JsonIterator(const std::unordered_map<std::string, JsonValue>::iterator &value)
-  : type_(JsonType::Object), value_(nullptr), object_iter_(value) {
+JsonIterator::JsonIterator(detail::JsonObject &object, std::size_t pos)
+  : type_(JsonType::Object), value_(nullptr), object_(&object), pos_(pos) {
 
 }
 
 JsonIterator::JsonIterator(const JsonIterator &other)
   : type_(other.type_), value_(other.value_), array_iter_(other.array_iter_),
-    object_iter_(other.object_iter_) {
+    object_(other.object_), pos_(other.pos_) {
 
 }
 
 JsonIterator::JsonIterator(JsonIterator &&other) noexcept
   : type_(other.type_), value_(other.value_),
     array_iter_(other.array_iter_),
-    object_iter_(other.object_iter_) {
+    object_(other.object_), pos_(other.pos_) {
   other.type_ = JsonType::Null;
   other.value_ = nullptr;
 }
@@ -39,7 +42,8 @@ JsonIterator &JsonIterator::operator=(const JsonIterator &other) {
   type_ = other.type_;
   value_ = other.value_;
   array_iter_ = other.array_iter_;
-  object_iter_ = other.object_iter_;
+  object_ = other.object_;
+  pos_ = other.pos_;
   return *this;
 }
 
@@ -47,7 +51,8 @@ JsonIterator &JsonIterator::operator=(JsonIterator &&other) noexcept {
   type_ = other.type_;
   value_ = other.value_;
   array_iter_ = other.array_iter_;
-  object_iter_ = other.object_iter_;
+  object_ = other.object_;
+  pos_ = other.pos_;
   other.type_ = JsonType::Null;
   other.value_ = nullptr;
   return *this;
@@ -57,7 +62,7 @@ JsonValue &JsonIterator::operator*() const {
   if (type_ == JsonType::Array) {
     return *array_iter_;
   } else if (type_ == JsonType::Object) {
-    return object_iter_->second;
+    return object_->getValuesRef()[pos_];
   }
   return *value_;
 }
@@ -66,7 +71,7 @@ JsonValue *JsonIterator::operator->() const {
   if (type_ == JsonType::Array) {
     return &(*array_iter_);
   } else if (type_ == JsonType::Object) {
-    return &(object_iter_->second);
+    return &object_->getValuesRef()[pos_];
   }
   return value_;
 }
@@ -75,7 +80,7 @@ JsonIterator &JsonIterator::operator++() {
   if (type_ == JsonType::Array) {
     ++array_iter_;
   } else if (type_ == JsonType::Object) {
-    ++object_iter_;
+    ++pos_;
   } else {
     value_ = nullptr;
   }
@@ -87,7 +92,7 @@ JsonIterator JsonIterator::operator++(int) {
   if (type_ == JsonType::Array) {
     ++array_iter_;
   } else if (type_ == JsonType::Object) {
-    ++object_iter_;
+    ++pos_;
   } else {
     value_ = nullptr;
   }
@@ -99,7 +104,7 @@ bool JsonIterator::operator==(const JsonIterator &rhs) const {
   if (type_ == JsonType::Array) {
     return array_iter_ == rhs.array_iter_;
   } else if (type_ == JsonType::Object) {
-    return object_iter_ == rhs.object_iter_;
+    return object_ == rhs.object_ && pos_ == rhs.pos_;
   }
   return value_ == rhs.value_;
 }
@@ -110,7 +115,7 @@ bool JsonIterator::operator!=(const JsonIterator &rhs) const {
 
 const std::string &JsonIterator::key() const {
   if (type_ == JsonType::Object) {
-    return object_iter_->first;
+    return object_->getKeys()[pos_].str();
   }
   static const std::string nullKey;
   return nullKey;
@@ -120,40 +125,41 @@ JsonValue &JsonIterator::value() const {
   return operator*();
 }
 
-JsonConstIterator::JsonConstIterator(JsonType type) : type_(type), value_(nullptr) {
+JsonConstIterator::JsonConstIterator(JsonType type)
+  : type_(type), value_(nullptr), object_(nullptr), pos_(0) {
 
 }
 
-JsonConstIterator::JsonConstIterator(const JsonValue &value) : type_(value.type_), value_(&value) {
+JsonConstIterator::JsonConstIterator(const JsonValue &value)
+  : type_(value.type_), value_(&value), object_(nullptr), pos_(0) {
 
 }
 
-JsonConstIterator::JsonConstIterator(const std::vector<JsonValue>::const_iterator &value)
-  : type_(JsonType::Array), value_(nullptr), array_iter_(value) {
+JsonConstIterator::JsonConstIterator(const JsonList::const_iterator &value)
+  : type_(JsonType::Array), value_(nullptr), array_iter_(value), object_(nullptr), pos_(0) {
 
 }
 
-JsonConstIterator::JsonConstIterator(
-  const std::unordered_map<std::string, JsonValue>::const_iterator &value)
-  : type_(JsonType::Object), value_(nullptr), object_iter_(value) {
+JsonConstIterator::JsonConstIterator(const detail::JsonObject &object, std::size_t pos)
+  : type_(JsonType::Object), value_(nullptr), object_(&object), pos_(pos) {
 
 }
 
 JsonConstIterator::JsonConstIterator(const JsonConstIterator &other)
   : type_(other.type_), value_(other.value_), array_iter_(other.array_iter_),
-    object_iter_(other.object_iter_) {
+    object_(other.object_), pos_(other.pos_) {
 
 }
 
 JsonConstIterator::JsonConstIterator(const JsonIterator &other)
   : type_(other.type_), value_(other.value_), array_iter_(other.array_iter_),
-    object_iter_(other.object_iter_) {
+    object_(other.object_), pos_(other.pos_) {
 }
 
 JsonConstIterator::JsonConstIterator(JsonConstIterator &&other) noexcept
   : type_(other.type_), value_(other.value_),
     array_iter_(other.array_iter_),
-    object_iter_(other.object_iter_) {
+    object_(other.object_), pos_(other.pos_) {
   other.type_ = JsonType::Null;
   other.value_ = nullptr;
 }
@@ -162,7 +168,8 @@ JsonConstIterator &JsonConstIterator::operator=(const JsonConstIterator &other)
   type_ = other.type_;
   value_ = other.value_;
   array_iter_ = other.array_iter_;
-  object_iter_ = other.object_iter_;
+  object_ = other.object_;
+  pos_ = other.pos_;
   return *this;
 }
 
@@ -170,7 +177,8 @@ JsonConstIterator &JsonConstIterator::operator=(const JsonIterator &other) {
   type_ = other.type_;
   value_ = other.value_;
   array_iter_ = other.array_iter_;
-  object_iter_ = other.object_iter_;
+  object_ = other.object_;
+  pos_ = other.pos_;
   return *this;
 }
 
@@ -178,7 +186,8 @@ JsonConstIterator &JsonConstIterator::operator=(JsonConstIterator &&other) noexc
   type_ = other.type_;
   value_ = other.value_;
   array_iter_ = other.array_iter_;
-  object_iter_ = other.object_iter_;
+  object_ = other.object_;
+  pos_ = other.pos_;
   other.type_ = JsonType::Null;
   other.value_ = nullptr;
   return *this;
@@ -188,7 +197,7 @@ const JsonValue &JsonConstIterator::operator*() const {
   if (type_ == JsonType::Array) {
     return *array_iter_;
   } else if (type_ == JsonType::Object) {
-    return object_iter_->second;
+    return object_->getValues()[pos_];
   }
   return *value_;
 }
@@ -197,7 +206,7 @@ const JsonValue *JsonConstIterator::operator->() const {
   if (type_ == JsonType::Array) {
     return &(*array_iter_);
   } else if (type_ == JsonType::Object) {
-    return &(object_iter_->second);
+    return &object_->getValues()[pos_];
   }
   return value_;
 }
@@ -206,7 +215,7 @@ JsonConstIterator &JsonConstIterator::operator++() {
   if (type_ == JsonType::Array) {
     ++array_iter_;
   } else if (type_ == JsonType::Object) {
-    ++object_iter_;
+    ++pos_;
   } else {
     value_ = nullptr;
   }
@@ -218,7 +227,7 @@ JsonConstIterator JsonConstIterator::operator++(int) {
   if (type_ == JsonType::Array) {
     ++array_iter_;
   } else if (type_ == JsonType::Object) {
-    ++object_iter_;
+    ++pos_;
   } else {
     value_ = nullptr;
   }
@@ -230,7 +239,7 @@ bool JsonConstIterator::operator==(const JsonConstIterator &rhs) const {
   if (type_ == JsonType::Array) {
     return array_iter_ == rhs.array_iter_;
   } else if (type_ == JsonType::Object) {
-    return object_iter_ == rhs.object_iter_;
+    return object_ == rhs.object_ && pos_ == rhs.pos_;
   }
   return value_ == rhs.value_;
 }
@@ -241,7 +250,7 @@ bool JsonConstIterator::operator!=(const JsonConstIterator &rhs) const {
 
 const std::string &JsonConstIterator::key() const {
   if (type_ == JsonType::Object) {
-    return object_iter_->first;
+    return object_->getKeys()[pos_].str();
   }
   static const std::string nullKey;
   return nullKey;
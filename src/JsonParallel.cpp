@@ -0,0 +1,417 @@
+// Copyright (c) 2023. SugerSalt
+
+#include "JsonParallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include "JsonReader.hpp"
+#include "detail/JsonImp.hpp"
+#include "detail/MappedFile.hpp"
+#include "detail/scan.hpp"
+#include "detail/tool.hpp"
+
+namespace suger {
+namespace detail {
+
+// Parses the documents of one chunk after another with its own reader. Errors count rows from
+// the start of the whole input.
+class LineWorker {
+public:
+  explicit LineWorker(const char *data) : data_(data) {}
+
+  template<class Sink>
+  void parse(const char *pos, const char *end, const Sink &sink) {
+    while ((pos = skipBlank(pos, end)) != end) {
+      reader_.reset(data_, end);
+      reader_.pos_ = pos;
+      JsonValue json;
+      reader_.readDom(json);
+      sink(static_cast<std::size_t>(pos - data_), json);
+      pos = reader_.pos_;
+    }
+  }
+
+private:
+  const char *data_;
+  JsonReader reader_;
+};
+
+// Splits a tree into subtrees of about grain values for the threads. The members of a larger
+// array or object are grouped into ranges, members which are large themselves are split again.
+// The split containers are created or written on the calling thread, the ranges by the tasks.
+class ParallelTree {
+public:
+  ParallelTree(unsigned threads, std::size_t grain) : threads_(threads), grain_(grain) {}
+
+  // false if the tree is too small to be split
+  bool plan(const JsonValue &root);
+  JsonValue copy(const JsonValue &root);
+  void dump(const JsonValue &root, std::string &out);
+
+private:
+  // members [first, last) of a split container, or its member first which is split itself
+  struct Part {
+    std::size_t first;
+    std::size_t last;
+    bool split;
+  };
+  // the parts of a split container in parts_
+  struct Range {
+    std::size_t begin;
+    std::size_t end;
+  };
+  // members [first, first + count) of the container from are copied to to
+  struct CopyTask {
+    const JsonValue *from;
+    std::size_t first;
+    JsonValue *to;
+    std::size_t count;
+  };
+  // the members of container are written into segment, keys is null for an array
+  struct DumpTask {
+    const JsonValue *container;
+    const JsonKey *keys;
+    std::size_t first;
+    std::size_t count;
+    std::size_t segment;
+  };
+
+  unsigned threads_;
+  std::size_t grain_;
+  std::vector<Part> parts_;
+  // parts of the containers being weighed
+  std::vector<Part> pending_;
+  std::unordered_map<const JsonBase *, Range> plan_;
+
+  static const JsonValue &member(const JsonValue &value, std::size_t i);
+  std::size_t weigh(const JsonValue &value);
+  JsonValue copySplit(const JsonValue &value, std::vector<CopyTask> &tasks);
+  void dumpSplit(const JsonValue &value, std::vector<std::string> &segments,
+                 std::vector<DumpTask> &tasks);
+};
+
+} // detail
+
+namespace {
+
+// small chunks would spend more time on scheduling than on parsing
+const std::size_t kMinChunkSize = 1 << 16;
+// chunks per thread, so a thread which got easy chunks takes over more of them
+const std::size_t kChunksPerThread = 8;
+
+unsigned threadCount(unsigned threads) {
+  if (threads == 0) {
+    threads = std::thread::hardware_concurrency();
+  }
+  return std::max(threads, 1u);
+}
+
+// chunk i is [bounds[i], bounds[i + 1]), every chunk but the last ends after a '\n'
+std::vector<const char *> splitLines(const char *data, std::size_t length, unsigned threads) {
+  std::size_t target = std::max(length / (threads * kChunksPerThread), kMinChunkSize);
+  const char *end = data + length;
+  std::vector<const char *> bounds{data};
+  const char *pos = data;
+  while (static_cast<std::size_t>(end - pos) > target) {
+    std::size_t rest = static_cast<std::size_t>(end - pos) - target;
+    auto line_end = static_cast<const char *>(std::memchr(pos + target, '\n', rest));
+    if (line_end == nullptr) {
+      break;
+    }
+    pos = line_end + 1;
+    bounds.push_back(pos);
+  }
+  if (pos != end) {
+    bounds.push_back(end);
+  }
+  return bounds;
+}
+
+// Run work(task, state) for every task, taking the tasks from a shared counter. Every thread gets
+// its own state from make_state. The first exception is thrown once all threads stopped.
+template<class MakeState, class Work>
+void runTasks(std::size_t task_count, unsigned threads, MakeState make_state, Work work) {
+  std::atomic<std::size_t> next(0);
+  std::atomic<bool> failed(false);
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto run = [&]() {
+    auto state = make_state();
+    std::size_t task;
+    while (!failed && (task = next++) < task_count) {
+      try {
+        work(task, state);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        failed = true;
+      }
+    }
+  };
+  std::vector<std::thread> pool;
+  std::size_t thread_count = std::min<std::size_t>(threads, task_count);
+  for (std::size_t i = 1; i < thread_count; ++i) {
+    pool.emplace_back(run);
+  }
+  run();
+  for (auto &thread: pool) {
+    thread.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+// Run work(chunk, worker) for every chunk, every thread parses with a worker of its own.
+template<class Work>
+void runChunks(const char *data, std::size_t chunk_count, unsigned threads, Work work) {
+  runTasks(chunk_count, threads, [data]() { return detail::LineWorker(data); }, work);
+}
+
+} // namespace
+
+namespace detail {
+
+bool ParallelTree::plan(const JsonValue &root) {
+  return weigh(root) > grain_ && plan_.count(root.data_.ptr) != 0;
+}
+
+JsonValue ParallelTree::copy(const JsonValue &root) {
+  std::vector<CopyTask> tasks;
+  JsonValue result = copySplit(root, tasks);
+  runTasks(tasks.size(), threads_, []() { return nullptr; },
+           [&](std::size_t task, std::nullptr_t) {
+    const CopyTask &copy = tasks[task];
+    for (std::size_t i = 0; i < copy.count; ++i) {
+      copy.to[i] = member(*copy.from, copy.first + i);
+    }
+  });
+  return result;
+}
+
+void ParallelTree::dump(const JsonValue &root, std::string &out) {
+  std::vector<std::string> segments(1);
+  std::vector<DumpTask> tasks;
+  dumpSplit(root, segments, tasks);
+  runTasks(tasks.size(), threads_, []() { return nullptr; },
+           [&](std::size_t task, std::nullptr_t) {
+    const DumpTask &dump = tasks[task];
+    std::string &segment = segments[dump.segment];
+    for (std::size_t i = 0; i < dump.count; ++i) {
+      if (i != 0) {
+        segment += ',';
+      }
+      if (dump.keys != nullptr) {
+        segment += '\"';
+        addTranslatedChar(dump.keys[dump.first + i].str(), segment);
+        segment += "\":";
+      }
+      member(*dump.container, dump.first + i).dump(segment);
+    }
+  });
+  std::size_t total = out.size();
+  for (const auto &segment: segments) {
+    total += segment.size();
+  }
+  out.reserve(total);
+  for (const auto &segment: segments) {
+    out += segment;
+  }
+}
+
+const JsonValue &ParallelTree::member(const JsonValue &value, std::size_t i) {
+  if (value.type_ == JsonType::Array) {
+    return static_cast<const JsonArray *>(value.data_.ptr)->getValue()[i];
+  }
+  return static_cast<const JsonObject *>(value.data_.ptr)->getValues()[i];
+}
+
+std::size_t ParallelTree::weigh(const JsonValue &value) {
+  if (value.type_ != JsonType::Array && value.type_ != JsonType::Object) {
+    return 1;
+  }
+  // packed arrays are copied at once and not split
+  if (value.isPacked()) {
+    return 1 + value.size();
+  }
+  std::size_t count = value.size();
+  std::size_t mark = pending_.size();
+  std::size_t total = 1;
+  std::size_t group = 0;
+  std::size_t first = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    const JsonValue &item = member(value, i);
+    std::size_t weight = weigh(item);
+    total += weight;
+    bool split = weight > grain_ && plan_.count(item.data_.ptr) != 0;
+    if (i != first && (split || group + weight > grain_)) {
+      pending_.push_back({first, i, false});
+      first = i;
+      group = 0;
+    }
+    if (split) {
+      pending_.push_back({i, i + 1, true});
+      first = i + 1;
+    } else {
+      group += weight;
+    }
+  }
+  if (count != first) {
+    pending_.push_back({first, count, false});
+  }
+  if (total > grain_) {
+    plan_[value.data_.ptr] = {parts_.size(), parts_.size() + pending_.size() - mark};
+    parts_.insert(parts_.end(), pending_.begin() + static_cast<std::ptrdiff_t>(mark),
+                  pending_.end());
+  }
+  pending_.resize(mark);
+  return total;
+}
+
+JsonValue ParallelTree::copySplit(const JsonValue &value, std::vector<CopyTask> &tasks) {
+  JsonValue result(value.type_);
+  JsonValue *to;
+  if (value.type_ == JsonType::Array) {
+    auto &list = static_cast<JsonArray *>(result.data_.ptr)->getRef();
+    list.resize(value.size());
+    to = list.data();
+  } else {
+    auto &object = *static_cast<JsonObject *>(result.data_.ptr);
+    object.copyKeys(*static_cast<const JsonObject *>(value.data_.ptr));
+    to = object.empty() ? nullptr : &object.getValuesRef()[0];
+  }
+  Range range = plan_[value.data_.ptr];
+  for (std::size_t i = range.begin; i < range.end; ++i) {
+    const Part &part = parts_[i];
+    if (part.split) {
+      to[part.first] = copySplit(member(value, part.first), tasks);
+    } else {
+      tasks.push_back({&value, part.first, to + part.first, part.last - part.first});
+    }
+  }
+  return result;
+}
+
+void ParallelTree::dumpSplit(const JsonValue &value, std::vector<std::string> &segments,
+                             std::vector<DumpTask> &tasks) {
+  bool is_array = value.type_ == JsonType::Array;
+  const JsonKey *keys = nullptr;
+  if (!is_array) {
+    keys = static_cast<const JsonObject *>(value.data_.ptr)->getKeys().data();
+  }
+  segments.back() += is_array ? '[' : '{';
+  Range range = plan_[value.data_.ptr];
+  for (std::size_t i = range.begin; i < range.end; ++i) {
+    const Part &part = parts_[i];
+    if (i != range.begin) {
+      segments.back() += ',';
+    }
+    if (part.split) {
+      if (keys != nullptr) {
+        segments.back() += '\"';
+        addTranslatedChar(keys[part.first].str(), segments.back());
+        segments.back() += "\":";
+      }
+      dumpSplit(member(value, part.first), segments, tasks);
+    } else {
+      tasks.push_back({&value, keys, part.first, part.last - part.first, segments.size()});
+      segments.emplace_back();
+      segments.emplace_back();
+    }
+  }
+  segments.back() += is_array ? ']' : '}';
+}
+
+} // detail
+
+std::vector<JsonValue> parseLinesParallel(const char *data, std::size_t length,
+                                          unsigned threads) {
+  threads = threadCount(threads);
+  std::vector<const char *> bounds = splitLines(data, length, threads);
+  std::size_t chunk_count = bounds.size() - 1;
+  std::vector<std::vector<JsonValue>> parts(chunk_count);
+  runChunks(data, chunk_count, threads, [&](std::size_t chunk, detail::LineWorker &worker) {
+    worker.parse(bounds[chunk], bounds[chunk + 1], [&](std::size_t, JsonValue &json) {
+      parts[chunk].push_back(std::move(json));
+    });
+  });
+  std::size_t total = 0;
+  for (const auto &part: parts) {
+    total += part.size();
+  }
+  std::vector<JsonValue> result;
+  result.reserve(total);
+  for (auto &part: parts) {
+    result.insert(result.end(), std::make_move_iterator(part.begin()),
+                  std::make_move_iterator(part.end()));
+  }
+  return result;
+}
+
+std::vector<JsonValue> parseLinesParallel(const std::string &data, unsigned threads) {
+  return parseLinesParallel(data.data(), data.size(), threads);
+}
+
+void parseLinesParallel(const char *data, std::size_t length, const JsonLineCallback &callback,
+                        unsigned threads) {
+  threads = threadCount(threads);
+  std::vector<const char *> bounds = splitLines(data, length, threads);
+  runChunks(data, bounds.size() - 1, threads, [&](std::size_t chunk, detail::LineWorker &worker) {
+    worker.parse(bounds[chunk], bounds[chunk + 1], callback);
+  });
+}
+
+void parseLinesParallel(const std::string &data, const JsonLineCallback &callback,
+                        unsigned threads) {
+  parseLinesParallel(data.data(), data.size(), callback, threads);
+}
+
+std::vector<JsonValue> parseFileLinesParallel(const std::string &path, unsigned threads) {
+  detail::MappedFile file(path);
+  return parseLinesParallel(file.data(), file.size(), threads);
+}
+
+void parseFileLinesParallel(const std::string &path, const JsonLineCallback &callback,
+                            unsigned threads) {
+  detail::MappedFile file(path);
+  parseLinesParallel(file.data(), file.size(), callback, threads);
+}
+
+JsonValue copyParallel(const JsonValue &value, unsigned threads, std::size_t grain) {
+  threads = threadCount(threads);
+  detail::ParallelTree tree(threads, grain);
+  // a shared tree is not copied at all
+  if (threads == 1 || value.isShareable() || !tree.plan(value)) {
+    return value;
+  }
+  return tree.copy(value);
+}
+
+std::string toStringParallel(const JsonValue &value, unsigned threads, std::size_t grain) {
+  if (value.isString()) {
+    return value.asString();
+  }
+  std::string out;
+  dumpParallel(value, out, threads, grain);
+  return out;
+}
+
+void dumpParallel(const JsonValue &value, std::string &out, unsigned threads,
+                  std::size_t grain) {
+  threads = threadCount(threads);
+  detail::ParallelTree tree(threads, grain);
+  if (threads == 1 || !tree.plan(value)) {
+    value.dump(out);
+    return;
+  }
+  tree.dump(value, out);
+}
+
+} // suger
@@ -0,0 +1,543 @@
+// Copyright (c) 2023. SugerSalt
+
+#include "JsonPushParser.hpp"
+#include "JsonError.hpp"
+#include "detail/ValueStack.hpp"
+#include "detail/number.hpp"
+#include "detail/scan.hpp"
+#include "detail/tool.hpp"
+
+namespace suger {
+
+// Builds the values like the DomBuilder of JsonReader, remembering where each key ended.
+class JsonPushParser::Builder {
+public:
+  explicit Builder(JsonPushParser &parser) : parser_(parser) {}
+
+  bool onNull() {
+    stack_.pushNull();
+    return true;
+  }
+  bool onBool(bool value) {
+    stack_.push(value);
+    return true;
+  }
+  bool onInt(int value) {
+    stack_.push(value);
+    return true;
+  }
+  bool onInt64(int64_t value) {
+    stack_.push(value);
+    return true;
+  }
+  bool onDouble(double value) {
+    stack_.push(value);
+    return true;
+  }
+  bool onString(std::string &value) {
+    stack_.pushString(value);
+    return true;
+  }
+  bool onStartObject() {
+    return true;
+  }
+  bool onKey(std::string &key) {
+    stack_.pushKey(key);
+    parser_.key_pos_.emplace_back(parser_.row_, parser_.key_end_ - parser_.line_begin_);
+    return true;
+  }
+  bool onEndObject(std::size_t count) {
+    std::size_t duplicate;
+    if (!stack_.endObject(count, duplicate)) {
+      auto &pos = parser_.key_pos_[duplicate];
+      parser_.throwParseError("Syntax error: Duplicate key \"" + stack_.key(duplicate) + "\".",
+                              pos.first, pos.second);
+    }
+    parser_.key_pos_.resize(parser_.key_pos_.size() - count);
+    return true;
+  }
+  bool onStartArray() {
+    return true;
+  }
+  bool onEndArray(std::size_t count) {
+    stack_.endArray(count);
+    return true;
+  }
+
+  JsonValue pop() {
+    return stack_.pop();
+  }
+  void clear() {
+    stack_.clear();
+  }
+  detail::ValueStack &stack() {
+    return stack_;
+  }
+
+private:
+  JsonPushParser &parser_;
+  detail::ValueStack stack_;
+};
+
+JsonPushParser::JsonPushParser() : handler_(nullptr), builder_(new Builder(*this)) {
+  reset();
+}
+
+JsonPushParser::JsonPushParser(JsonHandler &handler) : handler_(&handler) {
+  reset();
+}
+
+JsonPushParser::~JsonPushParser() = default;
+
+void JsonPushParser::setDuplicateKeyPolicy(DuplicateKeyPolicy policy) {
+  if (builder_) {
+    builder_->stack().setDuplicateKeyPolicy(policy);
+  }
+}
+
+DuplicateKeyPolicy JsonPushParser::duplicateKeyPolicy() const {
+  return builder_ ? builder_->stack().duplicateKeyPolicy() : DuplicateKeyPolicy::Reject;
+}
+
+void JsonPushParser::setPackedArrays(bool enable) {
+  if (builder_) {
+    builder_->stack().setPackedArrays(enable);
+  }
+}
+
+bool JsonPushParser::packedArrays() const {
+  return builder_ ? builder_->stack().packedArrays() : false;
+}
+
+std::size_t JsonPushParser::feed(const char *data, std::size_t length) {
+  completed_ = 0;
+  chunk_ = data;
+  if (handler_ != nullptr) {
+    parse(*handler_, data, data + length);
+  } else {
+    parse(*builder_, data, data + length);
+  }
+  chunk_offset_ += static_cast<int64_t>(length);
+  return completed_;
+}
+
+std::size_t JsonPushParser::feed(const std::string &data) {
+  return feed(data.data(), data.size());
+}
+
+std::size_t JsonPushParser::finish() {
+  completed_ = 0;
+  if (stopped_) {
+    return completed_;
+  }
+  switch (state_) {
+    case InNumber:
+      if (handler_ != nullptr) {
+        endNumber(*handler_, number_.data(), number_.data() + number_.size());
+      } else {
+        endNumber(*builder_, number_.data(), number_.data() + number_.size());
+      }
+      break;
+    case InString:
+      throwTokenError("Syntax error: incomplete string.");
+      break;
+    case InLiteral:
+      throwTokenError("Syntax error: value, object or array expected.");
+      break;
+    default:
+      break;
+  }
+  if (state_ != Idle && !stopped_) {
+    throwParseError(expected(), chunk_offset_);
+  }
+  return completed_;
+}
+
+bool JsonPushParser::stopped() const {
+  return stopped_;
+}
+
+bool JsonPushParser::inValue() const {
+  return state_ != Idle;
+}
+
+bool JsonPushParser::hasValue() const {
+  return !values_.empty();
+}
+
+JsonValue JsonPushParser::takeValue() {
+  JsonValue value;
+  if (!values_.empty()) {
+    value = std::move(values_.front());
+    values_.pop_front();
+  }
+  return value;
+}
+
+void JsonPushParser::reset() {
+  if (builder_) {
+    builder_->clear();
+  }
+  values_.clear();
+  state_ = Idle;
+  frames_.clear();
+  stopped_ = false;
+  completed_ = 0;
+  str_.clear();
+  is_key_ = false;
+  escape_ = false;
+  number_.clear();
+  number_part_ = NumberSign;
+  literal_ = nullptr;
+  literal_len_ = 0;
+  matched_ = 0;
+  chunk_ = nullptr;
+  chunk_offset_ = 0;
+  row_ = 0;
+  line_begin_ = 0;
+  token_row_ = 0;
+  token_col_ = 0;
+  key_end_ = 0;
+  key_pos_.clear();
+}
+
+template<class Handler>
+void JsonPushParser::parse(Handler &handler, const char *pos, const char *end) {
+  while (pos != end && !stopped_) {
+    // a token cut by the end of the previous chunk goes on
+    switch (state_) {
+      case InString:
+        pos = readString(handler, pos, end);
+        continue;
+      case InNumber:
+        pos = readNumber(handler, pos, end);
+        continue;
+      case InLiteral:
+        pos = readLiteral(handler, pos, end);
+        continue;
+      default:
+        break;
+    }
+    pos = skipBlank(pos, end);
+    if (pos == end) {
+      break;
+    }
+    char ch = *pos;
+    switch (state_) {
+      case FirstElement:
+        if (ch == ']') {
+          ++pos;
+          endContainer(handler);
+          break;
+        }
+        pos = beginValue(handler, pos);
+        break;
+      case Idle:
+      case Value:
+        pos = beginValue(handler, pos);
+        break;
+      case NextElement:
+        if (ch == ',') {
+          ++pos;
+          state_ = Value;
+        } else if (ch == ']') {
+          ++pos;
+          endContainer(handler);
+        } else {
+          throwParseError(expected(), offset(pos));
+        }
+        break;
+      case FirstKey:
+        if (ch == '}') {
+          ++pos;
+          endContainer(handler);
+          break;
+        }
+        // fall through
+      case Key:
+        if (ch != '\"') {
+          throwParseError(expected(), offset(pos));
+        }
+        beginToken(pos);
+        str_.clear();
+        is_key_ = true;
+        state_ = InString;
+        ++pos;
+        break;
+      case Colon:
+        if (ch != ':') {
+          throwParseError(expected(), offset(pos));
+        }
+        ++pos;
+        state_ = Value;
+        break;
+      case NextMember:
+        if (ch == ',') {
+          ++pos;
+          state_ = Key;
+        } else if (ch == '}') {
+          ++pos;
+          endContainer(handler);
+        } else {
+          throwParseError(expected(), offset(pos));
+        }
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+template<class Handler>
+const char *JsonPushParser::beginValue(Handler &handler, const char *pos) {
+  beginToken(pos);
+  switch (*pos) {
+    case '{':
+      frames_.push_back({true, 0});
+      state_ = FirstKey;
+      emit(handler.onStartObject());
+      return pos + 1;
+    case '[':
+      frames_.push_back({false, 0});
+      state_ = FirstElement;
+      emit(handler.onStartArray());
+      return pos + 1;
+    case '\"':
+      str_.clear();
+      is_key_ = false;
+      state_ = InString;
+      return pos + 1;
+    case 't':
+      literal_ = "true";
+      literal_len_ = 4;
+      break;
+    case 'f':
+      literal_ = "false";
+      literal_len_ = 5;
+      break;
+    case 'n':
+      literal_ = "null";
+      literal_len_ = 4;
+      break;
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+    case '+':
+    case '-':
+      number_.clear();
+      number_part_ = NumberSign;
+      state_ = InNumber;
+      return pos;
+    default:
+      throwTokenError("Syntax error: value, object or array expected.");
+  }
+  matched_ = 0;
+  state_ = InLiteral;
+  return pos;
+}
+
+// same as JsonReader::getString, but the string may end in a later chunk
+template<class Handler>
+const char *JsonPushParser::readString(Handler &handler, const char *pos, const char *end) {
+  while (pos != end) {
+    if (escape_) {
+      if (*pos == '\n') {
+        newLine(pos);
+      }
+      str_ += getTranslatedChar(*pos);
+      escape_ = false;
+      ++pos;
+      continue;
+    }
+    const char *special = detail::findStringSpecial(pos, end);
+    str_.append(pos, special);
+    pos = special;
+    if (pos == end) {
+      break;
+    }
+    char ch = *pos++;
+    if (ch == '\"') {
+      if (is_key_) {
+        key_end_ = offset(pos);
+        state_ = Colon;
+        emit(handler.onKey(str_));
+      } else {
+        emit(handler.onString(str_));
+        endValue();
+      }
+      break;
+    } else if (ch == '\\') {
+      escape_ = true;
+    } else if (ch == '\n') {
+      throwTokenError("Syntax error: incomplete string.");
+    } else {
+      str_ += ch;
+    }
+  }
+  return pos;
+}
+
+// Find where the number ends with the grammar of detail::scanNumber. Only a number which is cut
+// by the end of the chunk is copied.
+template<class Handler>
+const char *JsonPushParser::readNumber(Handler &handler, const char *pos, const char *end) {
+  const char *begin = pos;
+  for (; pos != end; ++pos) {
+    char ch = *pos;
+    bool digit = ch >= '0' && ch <= '9';
+    if (number_part_ == NumberSign) {
+      number_part_ = NumberInt;
+    } else if (digit && number_part_ != NumberExp) {
+      continue;
+    } else if (ch == '.' && number_part_ == NumberInt) {
+      number_part_ = NumberFrac;
+    } else if ((ch == 'e' || ch == 'E') &&
+               (number_part_ == NumberInt || number_part_ == NumberFrac)) {
+      number_part_ = NumberExp;
+    } else if (number_part_ == NumberExp && (digit || ch == '+' || ch == '-')) {
+      number_part_ = NumberExpDigits;
+    } else {
+      break;
+    }
+  }
+  if (pos == end) {
+    number_.append(begin, pos);
+  } else if (number_.empty()) {
+    endNumber(handler, begin, pos);
+  } else {
+    number_.append(begin, pos);
+    endNumber(handler, number_.data(), number_.data() + number_.size());
+  }
+  return pos;
+}
+
+template<class Handler>
+void JsonPushParser::endNumber(Handler &handler, const char *begin, const char *end) {
+  detail::ParsedNumber number;
+  detail::scanNumber(begin, end, number);
+  switch (number.type) {
+    case JsonType::Int:
+      emit(handler.onInt(number.i));
+      break;
+    case JsonType::Long:
+      emit(handler.onInt64(number.i64));
+      break;
+    default:
+      emit(handler.onDouble(number.d));
+      break;
+  }
+  endValue();
+}
+
+template<class Handler>
+const char *JsonPushParser::readLiteral(Handler &handler, const char *pos, const char *end) {
+  for (; pos != end && matched_ != literal_len_; ++pos, ++matched_) {
+    if (*pos != literal_[matched_]) {
+      throwTokenError("Syntax error: value, object or array expected.");
+    }
+  }
+  if (matched_ == literal_len_) {
+    if (*literal_ == 'n') {
+      emit(handler.onNull());
+    } else {
+      emit(handler.onBool(*literal_ == 't'));
+    }
+    endValue();
+  }
+  return pos;
+}
+
+template<class Handler>
+void JsonPushParser::endContainer(Handler &handler) {
+  Frame frame = frames_.back();
+  frames_.pop_back();
+  if (frame.object) {
+    emit(handler.onEndObject(frame.count));
+  } else {
+    emit(handler.onEndArray(frame.count));
+  }
+  endValue();
+}
+
+void JsonPushParser::endValue() {
+  if (frames_.empty()) {
+    state_ = Idle;
+    ++completed_;
+    if (builder_) {
+      values_.push_back(builder_->pop());
+    }
+  } else {
+    Frame &frame = frames_.back();
+    ++frame.count;
+    state_ = frame.object ? NextMember : NextElement;
+  }
+}
+
+void JsonPushParser::emit(bool go_on) {
+  if (!go_on) {
+    stopped_ = true;
+  }
+}
+
+const char *JsonPushParser::skipBlank(const char *pos, const char *end) {
+  const char *next = detail::skipBlank(pos, end);
+  for (; pos != next; ++pos) {
+    if (*pos == '\n') {
+      newLine(pos);
+    }
+  }
+  return next;
+}
+
+void JsonPushParser::newLine(const char *pos) {
+  ++row_;
+  line_begin_ = offset(pos) + 1;
+}
+
+void JsonPushParser::beginToken(const char *pos) {
+  token_row_ = row_;
+  token_col_ = offset(pos) - line_begin_;
+}
+
+int64_t JsonPushParser::offset(const char *pos) const {
+  return chunk_offset_ + (pos - chunk_);
+}
+
+// the error of JsonReader when the input does not go on as state_ requires
+const char *JsonPushParser::expected() const {
+  switch (state_) {
+    case FirstKey:
+    case Key:
+      return "Syntax error: key should be a string.";
+    case Colon:
+      return "Syntax error: missing ':' after object member name.";
+    case NextMember:
+      return "Syntax error: missing ',' or '}' in object declaration";
+    case NextElement:
+      return "Syntax error: missing ',' or ']' in array declaration";
+    default:
+      return "Syntax error: value, object or array expected.";
+  }
+}
+
+void JsonPushParser::throwParseError(const std::string &msg, int64_t row, int64_t col) const {
+  throw parse_error(msg + " At row: " + std::to_string(row + 1) + ", col: " +
+                    std::to_string(col + 1));
+}
+
+void JsonPushParser::throwParseError(const char *msg, int64_t pos) const {
+  throwParseError(msg, row_, pos - line_begin_);
+}
+
+void JsonPushParser::throwTokenError(const char *msg) const {
+  throwParseError(msg, token_row_, token_col_);
+}
+
+} // suger
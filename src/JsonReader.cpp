@@ -1,54 +1,165 @@
 // Copyright (c) 2023. SugerSalt
 
 #include "JsonReader.hpp"
-#include <iostream>
+#include <cstring>
+#include <iterator>
 #include "JsonError.hpp"
+#include "detail/MappedFile.hpp"
+#include "detail/StructuralIndex.hpp"
+#include "detail/ValueStack.hpp"
+#include "detail/number.hpp"
+#include "detail/scan.hpp"
+#include "detail/tool.hpp"
 
 namespace suger {
 
-JsonReader::JsonReader() : token_(BeginOfStream), pos_(nullptr), end_(nullptr), col_pos_(0),
-                           row_pos_(0) {
+JsonReader::JsonReader()
+    : token_(BeginOfStream), begin_(nullptr), pos_(nullptr), end_(nullptr), at_end_(false),
+      stack_(new detail::ValueStack()), use_index_(false) {
 
 }
 
+JsonReader::~JsonReader() = default;
+
+void JsonReader::setStructuralIndex(bool enable) {
+  if (enable && !index_) {
+    index_.reset(new detail::StructuralIndex());
+  }
+  use_index_ = enable;
+}
+
+bool JsonReader::structuralIndex() const {
+  return use_index_;
+}
+
+void JsonReader::setDuplicateKeyPolicy(DuplicateKeyPolicy policy) {
+  stack_->setDuplicateKeyPolicy(policy);
+}
+
+DuplicateKeyPolicy JsonReader::duplicateKeyPolicy() const {
+  return stack_->duplicateKeyPolicy();
+}
+
+void JsonReader::setPackedArrays(bool enable) {
+  stack_->setPackedArrays(enable);
+}
+
+bool JsonReader::packedArrays() const {
+  return stack_->packedArrays();
+}
+
 JsonValue JsonReader::parse(const std::string &document) {
+  return parse(document.data(), document.size());
+}
+
+JsonValue JsonReader::parse(const char *document) {
+  return parse(document, std::strlen(document));
+}
+
+JsonValue JsonReader::parse(const char *document, std::size_t length) {
   JsonValue json;
-  doc_ = document;
-  token_ = BeginOfStream;
-  pos_ = doc_.data();
-  end_ = doc_.data() + doc_.size();
-  readValue(json);
+  parse(document, length, json);
   return json;
 }
 
 JsonValue JsonReader::parse(std::istream &in) {
   JsonValue json;
-  doc_ = std::string(std::istreambuf_iterator<char>(in), {});
-  token_ = BeginOfStream;
-  pos_ = doc_.data();
-  end_ = doc_.data() + doc_.size();
-  readValue(json);
+  parse(in, json);
   return json;
 }
 
 bool JsonReader::parse(const std::string &document, JsonValue &json) {
-  doc_ = document;
-  token_ = BeginOfStream;
-  pos_ = doc_.data();
-  end_ = doc_.data() + doc_.size();
-  return readValue(json);
+  return parse(document.data(), document.size(), json);
+}
+
+bool JsonReader::parse(const char *document, JsonValue &json) {
+  return parse(document, std::strlen(document), json);
+}
+
+bool JsonReader::parse(const char *document, std::size_t length, JsonValue &json) {
+  reset(document, document + length);
+  readDom(json);
+  return true;
 }
 
 bool JsonReader::parse(std::istream &in, JsonValue &json) {
-  doc_ = std::string(std::istreambuf_iterator<char>(in), {});
+  doc_.assign(std::istreambuf_iterator<char>(in), {});
+  return parse(doc_.data(), doc_.size(), json);
+}
+
+JsonValue JsonReader::parseFile(const std::string &path) {
+  JsonValue json;
+  parseFile(path, json);
+  return json;
+}
+
+bool JsonReader::parseFile(const std::string &path, JsonValue &json) {
+  detail::MappedFile file(path);
+  return parse(file.data(), file.size(), json);
+}
+
+bool JsonReader::parseFile(const std::string &path, JsonDocument &doc) {
+  detail::MappedFile file(path);
+  return parse(file.data(), file.size(), doc);
+}
+
+bool JsonReader::parseFile(const std::string &path, JsonHandler &handler) {
+  detail::MappedFile file(path);
+  return parse(file.data(), file.size(), handler);
+}
+
+bool JsonReader::parse(const std::string &document, JsonDocument &doc) {
+  return parse(document.data(), document.size(), doc);
+}
+
+bool JsonReader::parse(const char *document, JsonDocument &doc) {
+  return parse(document, std::strlen(document), doc);
+}
+
+bool JsonReader::parse(const char *document, std::size_t length, JsonDocument &doc) {
+  reset(document, document + length);
+  readDocument(doc);
+  return true;
+}
+
+bool JsonReader::parse(const std::string &document, JsonHandler &handler) {
+  return parse(document.data(), document.size(), handler);
+}
+
+bool JsonReader::parse(const char *document, JsonHandler &handler) {
+  return parse(document, std::strlen(document), handler);
+}
+
+bool JsonReader::parse(const char *document, std::size_t length, JsonHandler &handler) {
+  reset(document, document + length);
+  return readValue(handler);
+}
+
+bool JsonReader::parse(std::istream &in, JsonHandler &handler) {
+  doc_.assign(std::istreambuf_iterator<char>(in), {});
+  return parse(doc_.data(), doc_.size(), handler);
+}
+
+void JsonReader::reset(const char *begin, const char *end) {
   token_ = BeginOfStream;
-  pos_ = doc_.data();
-  end_ = doc_.data() + doc_.size();
-  return readValue(json);
+  begin_ = begin;
+  pos_ = begin;
+  end_ = end;
+  at_end_ = false;
+  stack_->clear();
+  key_pos_.clear();
+  if (use_index_) {
+    index_->reset(begin, end);
+  }
 }
 
 JsonReader::TokenType JsonReader::getNextToken() {
   ignoreBlank();
+  if (pos_ == end_) {
+    at_end_ = true;
+    token_ = EndOfStream;
+    return token_;
+  }
   switch (*pos_) {
     case '{':
       token_ = ObjectBegin;
@@ -76,8 +187,6 @@ JsonReader::TokenType JsonReader::getNextToken() {
       break;
     case 't':
       if (strMatch("true", 4)) {
-        pos_ += 3;
-        col_pos_ += 3;
         token_ = True;
       } else {
         token_ = Error;
@@ -85,8 +194,6 @@ JsonReader::TokenType JsonReader::getNextToken() {
       break;
     case 'f':
       if (strMatch("false", 5)) {
-        pos_ += 4;
-        col_pos_ += 4;
         token_ = False;
       } else {
         token_ = Error;
@@ -94,16 +201,11 @@ JsonReader::TokenType JsonReader::getNextToken() {
       break;
     case 'n':
       if (strMatch("null", 4)) {
-        pos_ += 3;
-        col_pos_ += 3;
         token_ = Null;
       } else {
         token_ = Error;
       }
       break;
-    case '\0':
-      token_ = EndOfStream;
-      break;
     case '0':
     case '1':
     case '2':
@@ -126,191 +228,211 @@ JsonReader::TokenType JsonReader::getNextToken() {
 }
 
 void JsonReader::ignoreBlank() {
-  while (pos_ != end_) {
-    char ch = *pos_;
-    if (ch == ' ' || ch == '\t' || ch == '\r') {
-      ++pos_;
-      ++col_pos_;
-    } else if (ch == '\n') {
-      ++pos_;
-      ++row_pos_;
-      col_pos_ = 0;
-    } else {
-      break;
+  if (!use_index_) {
+    pos_ = detail::skipBlank(pos_, end_);
+    return;
+  }
+  // after blanks the next token is always indexed, anything else is the token itself
+  if (pos_ != end_ && *pos_ != ' ' && *pos_ != '\n' && *pos_ != '\t' && *pos_ != '\r') {
+    return;
+  }
+  pos_ = index_->next(pos_);
+}
+
+// Forwards the parse events to the value stack, remembering where each key was read.
+class JsonReader::DomBuilder {
+public:
+  explicit DomBuilder(JsonReader &reader) : reader_(reader), stack_(*reader.stack_) {}
+
+  bool onNull() {
+    stack_.pushNull();
+    return true;
+  }
+  bool onBool(bool value) {
+    stack_.push(value);
+    return true;
+  }
+  bool onInt(int value) {
+    stack_.push(value);
+    return true;
+  }
+  bool onInt64(int64_t value) {
+    stack_.push(value);
+    return true;
+  }
+  bool onDouble(double value) {
+    stack_.push(value);
+    return true;
+  }
+  // the string buffer of the reader is moved into the value instead of being copied
+  bool onString(std::string &value) {
+    stack_.pushString(value);
+    return true;
+  }
+  bool onStartObject() {
+    return true;
+  }
+  bool onKey(std::string &key) {
+    stack_.pushKey(key);
+    reader_.key_pos_.push_back(reader_.pos_);
+    return true;
+  }
+  bool onEndObject(std::size_t count) {
+    std::size_t duplicate;
+    if (!stack_.endObject(count, duplicate)) {
+      reader_.pos_ = reader_.key_pos_[duplicate];
+      reader_.throwParseError(
+          ("Syntax error: Duplicate key \"" + stack_.key(duplicate) + "\".").c_str());
     }
+    reader_.key_pos_.resize(reader_.key_pos_.size() - count);
+    return true;
+  }
+  bool onStartArray() {
+    return true;
+  }
+  bool onEndArray(std::size_t count) {
+    stack_.endArray(count);
+    return true;
   }
+
+private:
+  JsonReader &reader_;
+  detail::ValueStack &stack_;
+};
+
+void JsonReader::readDom(JsonValue &json) {
+  DomBuilder builder(*this);
+  readValue(builder);
+  json = stack_->pop();
+}
+
+void JsonReader::readDocument(JsonDocument &doc) {
+  doc.clear();
+  stack_->setArena(&doc.arena_);
+  stack_->setKeyTable(doc.intern_keys_ ? doc.keys_.get() : nullptr);
+  try {
+    readDom(doc.root_);
+  } catch (...) {
+    // the unfinished values still point into the arena
+    stack_->clear();
+    key_pos_.clear();
+    stack_->setArena(nullptr);
+    stack_->setKeyTable(nullptr);
+    doc.clear();
+    throw;
+  }
+  stack_->setArena(nullptr);
+  stack_->setKeyTable(nullptr);
 }
 
-//
-bool JsonReader::readValue(JsonValue &json) {
+template<class Handler>
+bool JsonReader::readValue(Handler &handler) {
   getNextToken();
   switch (token_) {
     case ObjectBegin:
-      return readObject(json);
+      return readObject(handler);
     case ArrayBegin:
-      return readArray(json);
+      return readArray(handler);
     case String:
-      return readString(json);
+      getString(str_);
+      return handler.onString(str_);
     case Number:
-      return readNumber(json);
+      return readNumber(handler);
     case True:
-      json = true;
-      break;
+      pos_ += 4;
+      return handler.onBool(true);
     case False:
-      json = false;
-      break;
+      pos_ += 5;
+      return handler.onBool(false);
     case Null:
-      json.reset();
-      break;
+      pos_ += 4;
+      return handler.onNull();
     default:
       throwParseError("Syntax error: value, object or array expected.");
   }
-  ++pos_;
-  ++col_pos_;
   return true;
 }
 
-bool JsonReader::readObject(JsonValue &json) {
-  json = JsonValue(JsonType::Object);
-  bool not_first = false;
+template<class Handler>
+bool JsonReader::readObject(Handler &handler) {
+  if (!handler.onStartObject()) {
+    return false;
+  }
+  std::size_t count = 0;
   ++pos_;
-  ++col_pos_;
   while (getNextToken() != ObjectEnd){
-    if (not_first){
+    if (count != 0){
       if (token_ != Separator) {
         throwParseError("Syntax error: missing ',' or '}' in object declaration");
       } else {
         ++pos_;
-        ++col_pos_;
         getNextToken();
       }
     }
-    not_first = true;
     // name
     if (token_ != String) {
       throwParseError("Syntax error: key should be a string.");
     }
-    auto name = getString();
-    if (json.isMember(name)) {
-      throwParseError(("Syntax error: Duplicate key \"" + name + "\".").c_str());
+    getString(str_);
+    if (!handler.onKey(str_)) {
+      return false;
     }
     if (getNextToken() != MemberSeparator) {
       throwParseError("Syntax error: missing ':' after object member name.");
     }
     // member
     ++pos_;
-    ++col_pos_;
-    JsonValue member;
-    readValue(member);
-    json.push_back(name, std::move(member));
+    if (!readValue(handler)) {
+      return false;
+    }
+    ++count;
   }
   ++pos_;
-  ++col_pos_;
-  return true;
+  return handler.onEndObject(count);
 }
 
-bool JsonReader::readArray(JsonValue &json) {
-  json = JsonValue(JsonType::Array);
-  bool not_first = false;
+template<class Handler>
+bool JsonReader::readArray(Handler &handler) {
+  if (!handler.onStartArray()) {
+    return false;
+  }
+  std::size_t count = 0;
   ++pos_;
-  ++col_pos_;
   while (getNextToken() != ArrayEnd){
-    if (not_first){
+    if (count != 0){
       if (token_ != Separator) {
         throwParseError("Syntax error: missing ',' or ']' in array declaration");
       } else {
         ++pos_;
-        ++col_pos_;
         getNextToken();
       }
     }
-    not_first = true;
-    JsonValue member;
-    readValue(member);
-    json.push_back(std::move(member));
+    if (!readValue(handler)) {
+      return false;
+    }
+    ++count;
   }
   ++pos_;
-  ++col_pos_;
-  return true;
-}
-
-bool JsonReader::readString(JsonValue &json) {
-  json = getString();
-  return true;
+  return handler.onEndArray(count);
 }
 
-bool JsonReader::readNumber(JsonValue &json) {
-  size_t i = 0;
-  bool negative = false;
-  bool is_int = true;
-  double double_result = 0.0;
-  int64_t long_result = 0;
-
-  auto isDigit = [](char ch) { return ch >= '0' && ch <= '9'; };
-
-  if (pos_[i] == '-') {
-    negative = true;
-    ++i;
-  } else if (pos_[i] == '+') {
-    ++i;
-  }
-  while (pos_ + i < end_ && isDigit(pos_[i])) {
-    double_result = double_result * 10 + (pos_[i] - '0');
-    long_result = long_result * 10 + (pos_[i] - '0');
-    ++i;
-  }
-  if (pos_ + i < end_ && pos_[i] == '.') {
-    is_int = false;
-    double fraction = 0.1;
-    ++i;
-    while (pos_ + i < end_ && isDigit(pos_[i])) {
-      double_result = double_result + (pos_[i] - '0') * fraction;
-      fraction *= 0.1;
-      ++i;
-    }
-  }
-  if (pos_ + i < end_ && (pos_[i] == 'e' || pos_[i] == 'E')) {
-    is_int = false;
-    ++i;
-    bool exponentNegative = false;
-    if (pos_[i] == '-') {
-      exponentNegative = true;
-      ++i;
-    } else if (pos_[i] == '+') {
-      ++i;
-    }
-    int exponent = 0;
-    while (pos_ + i < end_ && isDigit(pos_[i])) {
-      exponent = exponent * 10 + (pos_[i] - '0');
-      ++i;
-    }
-    double power = 1.0;
-    for (int j = 0; j < exponent; j++) {
-      power *= 10.0;
-    }
-    if (exponentNegative) {
-      double_result /= power;
-    } else {
-      double_result *= power;
-    }
-  }
-  if (negative) {
-    double_result = -double_result;
-  }
-  if (is_int && long_result<INT32_MAX && long_result>INT32_MIN) {
-    json = static_cast<int>(long_result);
-  } else if (is_int) {
-    json = long_result;
-  } else {
-    json = double_result;
+template<class Handler>
+bool JsonReader::readNumber(Handler &handler) {
+  detail::ParsedNumber number;
+  pos_ = detail::scanNumber(pos_, end_, number);
+  switch (number.type) {
+    case JsonType::Int:
+      return handler.onInt(number.i);
+    case JsonType::Long:
+      return handler.onInt64(number.i64);
+    default:
+      return handler.onDouble(number.d);
   }
-  pos_ += i;
-  col_pos_ += i;
-  return true;
 }
 
 bool JsonReader::strMatch(const char *pattern, int len) {
   if (end_ - pos_ < len) {
+    at_end_ = true;
     return false;
   }
   for (int i = 0; i < len; ++i) {
@@ -321,44 +443,42 @@ bool JsonReader::strMatch(const char *pattern, int len) {
   return true;
 }
 
+// row and column are only needed for errors, so they are counted here instead of while parsing
 void JsonReader::throwParseError(const char *msg) const {
-  std::string error_msg = msg;
-  error_msg +=
-    " At row: " + std::to_string(row_pos_ + 1) + ", col: " + std::to_string(col_pos_ + 1);
-  throw parse_error(error_msg);
+  suger::throwParseError(msg, begin_, pos_);
 }
 
-// get from " to "
-std::string JsonReader::getString() {
-  std::string str;
+// get from " to ", str is overwritten
+void JsonReader::getString(std::string &str) {
+  if (use_index_) {
+    // nothing to unescape when the closing quote is the next token
+    const char *close = index_->next(pos_ + 1);
+    if (close != end_ && *close == '\"') {
+      str.assign(pos_ + 1, close);
+      pos_ = close + 1;
+      return;
+    }
+  }
+  str.clear();
   const char *pos = pos_ + 1;
-  while (pos != end_) {
+  while (true) {
+    const char *special = detail::findStringSpecial(pos, end_);
+    str.append(pos, special);
+    pos = special;
+    if (pos == end_) {
+      at_end_ = true;
+      throwParseError("Syntax error: incomplete string.");
+    }
     char ch = *pos;
     if (ch == '\"') {
       ++pos;
       break;
     } else if (ch == '\\') {
-      ++pos;
-      ch = *pos;
-      switch (ch) {
-        case 'b':
-          str += '\b';
-          break;
-        case 'f':
-          str += '\f';
-          break;
-        case 'n':
-          str += '\n';
-          break;
-        case 'r':
-          str += '\r';
-          break;
-        case 't':
-          str += '\t';
-          break;
-        default:
-          str += ch;
+      if (++pos == end_) {
+        at_end_ = true;
+        throwParseError("Syntax error: incomplete string.");
       }
+      str += getTranslatedChar(*pos);
     } else if (ch == '\n') {
       throwParseError("Syntax error: incomplete string.");
     } else {
@@ -366,12 +486,7 @@ std::string JsonReader::getString() {
     }
     ++pos;
   }
-  if (pos == end_) {
-    throwParseError("Syntax error: incomplete string.");
-  }
-  col_pos_ += pos - pos_;
   pos_ = pos;
-  return str;
 }
 
 std::istream &operator>>(std::istream &in, JsonValue &json){
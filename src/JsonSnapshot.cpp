@@ -0,0 +1,79 @@
+// Copyright (c) 2023. SugerSalt
+
+#include "JsonSnapshot.hpp"
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include "JsonReader.hpp"
+
+namespace suger {
+
+JsonSnapshot::JsonSnapshot() : JsonSnapshot(JsonValue()) {}
+
+JsonSnapshot::JsonSnapshot(JsonValue value)
+    : current_(new Version(std::make_shared<const JsonValue>(std::move(value)))),
+      epoch_(0), readers_{{0}, {0}}, version_(0) {}
+
+JsonSnapshot::~JsonSnapshot() {
+  delete current_.load();
+}
+
+std::shared_ptr<const JsonValue> JsonSnapshot::load() const {
+  for (;;) {
+    uint32_t epoch = epoch_.load() & 1;
+    readers_[epoch].fetch_add(1);
+    // A writer which flipped the epoch in between may not wait for this counter,
+    // so register again under the new epoch.
+    if ((epoch_.load() & 1) != epoch) {
+      readers_[epoch].fetch_sub(1);
+      continue;
+    }
+    Version version = *current_.load();
+    readers_[epoch].fetch_sub(1);
+    return version;
+  }
+}
+
+uint64_t JsonSnapshot::version() const {
+  return version_.load();
+}
+
+void JsonSnapshot::store(JsonValue value) {
+  store(std::make_shared<const JsonValue>(std::move(value)));
+}
+
+void JsonSnapshot::store(std::shared_ptr<const JsonValue> value) {
+  if (value == nullptr) {
+    throw std::invalid_argument("JsonSnapshot can not store a null pointer");
+  }
+  auto *next = new Version(std::move(value));
+  std::lock_guard<std::mutex> lock(writer_);
+  const Version *prev = current_.exchange(next);
+  version_.fetch_add(1);
+  uint32_t epoch = epoch_.fetch_add(1) & 1;
+  // readers of the old epoch may still be copying prev, later ones see next
+  while (readers_[epoch].load() != 0) {
+    std::this_thread::yield();
+  }
+  delete prev;
+}
+
+void JsonSnapshot::reload(const std::string &document) {
+  JsonReader reader;
+  reload(document, reader);
+}
+
+void JsonSnapshot::reload(const std::string &document, JsonReader &reader) {
+  store(reader.parse(document));
+}
+
+void JsonSnapshot::reloadFile(const std::string &path) {
+  JsonReader reader;
+  reloadFile(path, reader);
+}
+
+void JsonSnapshot::reloadFile(const std::string &path, JsonReader &reader) {
+  store(reader.parseFile(path));
+}
+
+} // suger
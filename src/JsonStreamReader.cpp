@@ -0,0 +1,91 @@
+// Copyright (c) 2023. SugerSalt
+
+#include "JsonStreamReader.hpp"
+#include <cstring>
+#include "JsonError.hpp"
+#include "detail/scan.hpp"
+
+namespace suger {
+
+const std::size_t JsonStreamReader::kDefaultBufferSize;
+
+JsonStreamReader::JsonStreamReader(std::istream &in, std::size_t buffer_size)
+    : in_(&in), buffer_(buffer_size > 0 ? buffer_size : 1, '\0'), pos_(buffer_.data()),
+      end_(buffer_.data()), eof_(false), count_(0) {
+
+}
+
+JsonStreamReader::JsonStreamReader(const char *data, std::size_t length)
+    : in_(nullptr), pos_(data), end_(data + length), eof_(true), count_(0) {
+
+}
+
+JsonStreamReader::JsonStreamReader(const std::string &data)
+    : JsonStreamReader(data.data(), data.size()) {
+
+}
+
+bool JsonStreamReader::next(JsonValue &json) {
+  return readNext([&] { reader_.readDom(json); });
+}
+
+bool JsonStreamReader::next(JsonDocument &doc) {
+  return readNext([&] { reader_.readDocument(doc); });
+}
+
+std::size_t JsonStreamReader::count() const {
+  return count_;
+}
+
+// A document which runs into the end of the buffer is parsed again once more of the stream is
+// read, so only the last document of each block is parsed twice.
+template<class Read>
+bool JsonStreamReader::readNext(Read read) {
+  while (true) {
+    pos_ = detail::skipBlank(pos_, end_);
+    if (pos_ == end_) {
+      if (eof_) {
+        return false;
+      }
+      refill();
+      continue;
+    }
+    reader_.reset(pos_, end_);
+    try {
+      read();
+    } catch (parse_error &) {
+      if (eof_ || !reader_.at_end_) {
+        throw;
+      }
+      refill();
+      continue;
+    }
+    // a number could go on in the next block
+    if (reader_.pos_ == end_ && !eof_) {
+      refill();
+      continue;
+    }
+    pos_ = reader_.pos_;
+    ++count_;
+    return true;
+  }
+}
+
+void JsonStreamReader::refill() {
+  std::size_t kept = static_cast<std::size_t>(end_ - pos_);
+  char *data = &buffer_[0];
+  std::memmove(data, pos_, kept);
+  if (kept == buffer_.size()) {
+    buffer_.resize(buffer_.size() * 2);
+    data = &buffer_[0];
+  }
+  in_->read(data + kept, static_cast<std::streamsize>(buffer_.size() - kept));
+  std::size_t got = static_cast<std::size_t>(in_->gcount());
+  if (got == 0 || !*in_) {
+    eof_ = true;
+  }
+  pos_ = data;
+  end_ = data + kept + got;
+}
+
+} // suger
@@ -1,283 +1,188 @@
 // Copyright (c) 2023. SugerSalt
 
 #include "JsonValue.hpp"
+#include "JsonFrozen.hpp"
 #include "detail/JsonImp.hpp"
 #include "JsonError.hpp"
+#include "detail/number.hpp"
 
 
 namespace suger {
 using namespace detail;
 
-JsonValue::JsonValue() : type_(JsonType::Null) {
+namespace {
+
+JsonIterator objectIterator(JsonObject &data, std::size_t pos) {
+  return JsonIterator(data, pos);
+}
+
+JsonConstIterator objectIterator(const JsonObject &data, std::size_t pos) {
+  return JsonConstIterator(data, pos);
+}
+
+} // namespace
+
+JsonValue::JsonValue() : type_(JsonType::Null), data_() {
 
 }
 
 #if __cplusplus < 201103L
 #error "The compiler should support at least c++11."
-#elif __cplusplus < 201402L
+#endif
+
 JsonValue::JsonValue(JsonType type) : type_(type) {
   switch (type) {
     case JsonType::Null:
       break;
     case JsonType::Boolean:
-      data_ = std::unique_ptr<JsonBool>();
+      data_.b = false;
       break;
     case JsonType::Int:
-      data_ = std::unique_ptr<JsonNumber>(new JsonNumber(0));
+      data_.i = 0;
       break;
     case JsonType::Long:
-      data_ = std::unique_ptr<JsonNumber>(new JsonNumber(static_cast<int64_t>(0)));
+      data_.i64 = 0;
       break;
     case JsonType::Double:
-      data_ = std::unique_ptr<JsonNumber>(new JsonNumber(0.0));
+      data_.d = 0.0;
       break;
     case JsonType::String:
-      data_ = std::unique_ptr<JsonString>(new JsonString());
+      data_.ptr = new JsonString();
       break;
     case JsonType::Array:
-      data_ = std::unique_ptr<JsonArray>(new JsonArray());
+      data_.ptr = new JsonArray();
       break;
     case JsonType::Object:
-      data_ = std::unique_ptr<JsonObject>(new JsonObject());
+      data_.ptr = new JsonObject();
       break;
   }
 }
 
-JsonValue::JsonValue(bool value)
-  : type_(JsonType::Boolean), data_(new JsonBool(value)) {
+JsonValue::JsonValue(bool value) : type_(JsonType::Boolean) {
+  data_.b = value;
 }
 
-JsonValue::JsonValue(int value)
-  : type_(JsonType::Int), data_(new JsonNumber(value)) {
+JsonValue::JsonValue(int value) : type_(JsonType::Int) {
+  data_.i = value;
 }
 
-JsonValue::JsonValue(int64_t value)
-  : type_(JsonType::Long), data_(new JsonNumber(value)) {
+JsonValue::JsonValue(int64_t value) : type_(JsonType::Long) {
+  data_.i64 = value;
 }
 
-JsonValue::JsonValue(double value)
-  : type_(JsonType::Double), data_(new JsonNumber(value)) {
+JsonValue::JsonValue(double value) : type_(JsonType::Double) {
+  data_.d = value;
 }
 
-JsonValue::JsonValue(const std::string &value)
-  : type_(JsonType::String), data_(new JsonString(value)) {
+JsonValue::JsonValue(const std::string &value) : type_(JsonType::String) {
+  data_.ptr = new JsonString(value);
 }
 
-JsonValue::JsonValue(const char *value)
-  : type_(JsonType::String), data_(new JsonString(value)) {
+JsonValue::JsonValue(const char *value) : type_(JsonType::String) {
+  data_.ptr = new JsonString(value);
 }
 
-JsonValue::JsonValue(const std::vector<JsonValue> &value)
-  : type_(JsonType::Array), data_(new JsonArray(value)) {
+JsonValue::JsonValue(const std::vector<JsonValue> &value) : type_(JsonType::Array) {
+  data_.ptr = new JsonArray(value);
 }
 
-JsonValue::JsonValue(const std::vector<bool> &value)
-  : type_(JsonType::Array), data_(new JsonArray(value)) {
+JsonValue::JsonValue(const std::vector<bool> &value) : type_(JsonType::Array) {
+  data_.ptr = new JsonArray(value);
 }
 
-JsonValue::JsonValue(const std::vector<int> &value)
-  : type_(JsonType::Array), data_(new JsonArray(value)) {
+JsonValue::JsonValue(const std::vector<int> &value) : type_(JsonType::Array) {
+  data_.ptr = new JsonArray(value);
 }
 
-JsonValue::JsonValue(const std::vector<int64_t> &value)
-  : type_(JsonType::Array), data_(new JsonArray(value)) {
+JsonValue::JsonValue(const std::vector<int64_t> &value) : type_(JsonType::Array) {
+  data_.ptr = new JsonArray(value);
 }
 
-JsonValue::JsonValue(const std::vector<double> &value)
-  : type_(JsonType::Array), data_(new JsonArray(value)) {
+JsonValue::JsonValue(const std::vector<double> &value) : type_(JsonType::Array) {
+  data_.ptr = new JsonArray(value);
 }
 
-JsonValue::JsonValue(const std::vector<std::string> &value)
-  : type_(JsonType::Array), data_(new JsonArray(value)) {
+JsonValue::JsonValue(const std::vector<std::string> &value) : type_(JsonType::Array) {
+  data_.ptr = new JsonArray(value);
 }
 
-JsonValue::JsonValue(const std::initializer_list<bool> &value)
-  : type_(JsonType::Array), data_(new JsonArray(value)) {
+JsonValue::JsonValue(const std::initializer_list<bool> &value) : type_(JsonType::Array) {
+  data_.ptr = new JsonArray(value);
 }
 
-JsonValue::JsonValue(const std::initializer_list<int> &value)
-  : type_(JsonType::Array), data_(new JsonArray(value)) {
+JsonValue::JsonValue(const std::initializer_list<int> &value) : type_(JsonType::Array) {
+  data_.ptr = new JsonArray(value);
 }
 
-JsonValue::JsonValue(const std::initializer_list<int64_t> &value)
-  : type_(JsonType::Array), data_(new JsonArray(value)) {
+JsonValue::JsonValue(const std::initializer_list<int64_t> &value) : type_(JsonType::Array) {
+  data_.ptr = new JsonArray(value);
 }
 
-JsonValue::JsonValue(const std::initializer_list<double> &value)
-  : type_(JsonType::Array), data_(new JsonArray(value)) {
+JsonValue::JsonValue(const std::initializer_list<double> &value) : type_(JsonType::Array) {
+  data_.ptr = new JsonArray(value);
 }
 
-JsonValue::JsonValue(const std::initializer_list<std::string> &value)
-  : type_(JsonType::Array), data_(new JsonArray(value)) {
+JsonValue::JsonValue(const std::initializer_list<std::string> &value) : type_(JsonType::Array) {
+  data_.ptr = new JsonArray(value);
 }
 
-JsonValue::JsonValue(const std::initializer_list<const char *> &value)
-  : type_(JsonType::Array),
-    data_(new JsonArray(std::vector<std::string>(value.begin(), value.end()))) {
+JsonValue::JsonValue(const std::initializer_list<const char *> &value) : type_(JsonType::Array) {
+  data_.ptr = new JsonArray(std::vector<std::string>(value.begin(), value.end()));
 }
 
-JsonValue::JsonValue(const JsonValue &other) {
-  type_ = other.type_;
-  switch (other.type_) {
-    case JsonType::Null:
-      break;
-    case JsonType::Boolean:
-      data_ = std::unique_ptr<JsonBool>(new JsonBool(*static_cast<JsonBool *>(other.data_.get())));
-      break;
-    case JsonType::Int:
-    case JsonType::Long:
-    case JsonType::Double:
-      data_ = std::unique_ptr<JsonNumber>(
-        new JsonNumber(*static_cast<JsonNumber *>(other.data_.get())));
-      break;
-    case JsonType::String:
-      data_ = std::unique_ptr<JsonString>(
-        new JsonString(*static_cast<JsonString *>(other.data_.get())));
-      break;
-    case JsonType::Array:
-      data_ = std::unique_ptr<JsonArray>(
-        new JsonArray(*static_cast<JsonArray *>(other.data_.get())));
-      break;
-    case JsonType::Object:
-      data_ = std::unique_ptr<JsonObject>(
-        new JsonObject(*static_cast<JsonObject *>(other.data_.get())));
-      break;
-  }
-}
-#else
-
-JsonValue::JsonValue(JsonType type) : type_(type) {
+JsonValue::JsonValue(JsonType type, JsonArena *arena) : type_(type), data_() {
   switch (type) {
-    case JsonType::Null:
-      break;
-    case JsonType::Boolean:
-      data_ = std::make_unique<JsonBool>();
-      break;
-    case JsonType::Int:
-      data_ = std::make_unique<JsonNumber>(0);
-      break;
-    case JsonType::Long:
-      data_ = std::make_unique<JsonNumber>(static_cast<int64_t>(0));
-      break;
-    case JsonType::Double:
-      data_ = std::make_unique<JsonNumber>(0.0);
-      break;
     case JsonType::String:
-      data_ = std::make_unique<JsonString>();
+      data_.ptr = arena == nullptr ? new JsonString()
+                                   : arena->create<JsonString>(std::string(), true);
       break;
     case JsonType::Array:
-      data_ = std::make_unique<JsonArray>();
+      data_.ptr = arena == nullptr ? new JsonArray() : arena->create<JsonArray>(arena);
       break;
     case JsonType::Object:
-      data_ = std::make_unique<JsonObject>();
+      data_.ptr = arena == nullptr ? new JsonObject() : arena->create<JsonObject>(arena);
+      break;
+    default:
       break;
   }
 }
 
-JsonValue::JsonValue(bool value)
-  : type_(JsonType::Boolean), data_(std::make_unique<JsonBool>(value)) {
-}
-
-JsonValue::JsonValue(int value)
-  : type_(JsonType::Int), data_(std::make_unique<JsonNumber>(value)) {
-}
-
-JsonValue::JsonValue(int64_t value)
-  : type_(JsonType::Long), data_(std::make_unique<JsonNumber>(value)) {
-}
-
-JsonValue::JsonValue(double value)
-  : type_(JsonType::Double), data_(std::make_unique<JsonNumber>(value)) {
-}
-
-JsonValue::JsonValue(const std::string &value)
-  : type_(JsonType::String), data_(std::make_unique<JsonString>(value)) {
-}
-
-JsonValue::JsonValue(const char *value)
-  : type_(JsonType::String), data_(std::make_unique<JsonString>(value)) {
-}
-
-JsonValue::JsonValue(const std::vector<JsonValue> &value)
-  : type_(JsonType::Array), data_(std::make_unique<JsonArray>(value)) {
-}
-
-JsonValue::JsonValue(const std::vector<bool> &value)
-  : type_(JsonType::Array), data_(std::make_unique<JsonArray>(value)) {
-}
-
-JsonValue::JsonValue(const std::vector<int> &value)
-  : type_(JsonType::Array), data_(std::make_unique<JsonArray>(value)) {
-}
-
-JsonValue::JsonValue(const std::vector<int64_t> &value)
-  : type_(JsonType::Array), data_(std::make_unique<JsonArray>(value)) {
-}
-
-JsonValue::JsonValue(const std::vector<double> &value)
-  : type_(JsonType::Array), data_(std::make_unique<JsonArray>(value)) {
-}
-
-JsonValue::JsonValue(const std::vector<std::string> &value)
-  : type_(JsonType::Array), data_(std::make_unique<JsonArray>(value)) {
-}
-
-JsonValue::JsonValue(const std::initializer_list<bool> &value)
-  : type_(JsonType::Array), data_(std::make_unique<JsonArray>(value)) {
-}
-
-JsonValue::JsonValue(const std::initializer_list<int> &value)
-  : type_(JsonType::Array), data_(std::make_unique<JsonArray>(value)) {
-}
-
-JsonValue::JsonValue(const std::initializer_list<int64_t> &value)
-  : type_(JsonType::Array), data_(std::make_unique<JsonArray>(value)) {
-}
-
-JsonValue::JsonValue(const std::initializer_list<double> &value)
-  : type_(JsonType::Array), data_(std::make_unique<JsonArray>(value)) {
-}
-
-JsonValue::JsonValue(const std::initializer_list<std::string> &value)
-  : type_(JsonType::Array), data_(std::make_unique<JsonArray>(value)) {
-}
-
-JsonValue::JsonValue(const std::initializer_list<const char *> &value)
-  : type_(JsonType::Array),
-    data_(std::make_unique<JsonArray>(std::vector<std::string>(value.begin(), value.end()))) {
+JsonValue::JsonValue(std::string &&value, JsonArena *arena) : type_(JsonType::String) {
+  if (arena == nullptr) {
+    data_.ptr = new JsonString(std::move(value));
+    return;
+  }
+  auto node = arena->create<JsonString>(std::move(value), true);
+  if (usesHeap(node->getValue())) {
+    arena->addCleanup(node, [](void *object) {
+      static_cast<JsonString *>(object)->~JsonString();
+    });
+  }
+  data_.ptr = node;
 }
 
-JsonValue::JsonValue(const JsonValue &other) {
-  type_ = other.type_;
+JsonValue::JsonValue(const JsonValue &other) : type_(other.type_), data_(other.data_) {
   switch (other.type_) {
-    case JsonType::Null:
-      break;
-    case JsonType::Boolean:
-      data_ = std::make_unique<JsonBool>(*static_cast<JsonBool *>(other.data_.get()));
-      break;
-    case JsonType::Int:
-    case JsonType::Long:
-    case JsonType::Double:
-      data_ = std::make_unique<JsonNumber>(*static_cast<JsonNumber *>(other.data_.get()));
-      break;
     case JsonType::String:
-      data_ = std::make_unique<JsonString>(*static_cast<JsonString *>(other.data_.get()));
-      break;
     case JsonType::Array:
-      data_ = std::make_unique<JsonArray>(*static_cast<JsonArray *>(other.data_.get()));
-      break;
     case JsonType::Object:
-      data_ = std::make_unique<JsonObject>(*static_cast<JsonObject *>(other.data_.get()));
+      if (data_.ptr->shareable()) {
+        data_.ptr->ref();
+      } else {
+        data_.ptr = other.cloneNode();
+      }
+      break;
+    default:
       break;
   }
 }
 
-#endif
-
-JsonValue::JsonValue(JsonValue &&other) noexcept {
-  type_ = other.type_;
+JsonValue::JsonValue(JsonValue &&other) noexcept : type_(other.type_), data_(other.data_) {
   other.type_ = JsonType::Null;
-  data_ = std::move(other.data_);
+}
+
+JsonValue::~JsonValue() {
+  release();
 }
 
 JsonValue &JsonValue::operator=(const JsonValue &value) {
@@ -290,7 +195,7 @@ JsonValue &JsonValue::operator=(JsonValue &&value) noexcept {
   return *this;
 }
 
-void JsonValue::swap(JsonValue &other) {
+void JsonValue::swap(JsonValue &other) noexcept {
   std::swap(type_, other.type_);
   std::swap(data_, other.data_);
 }
@@ -337,45 +242,41 @@ bool JsonValue::isObject() const {
 
 bool JsonValue::asBoolean() const {
   if (!isBoolean()) throw type_error(type_, JsonType::Boolean);
-  auto data = static_cast<JsonBool *>(data_.get());
-  return data->getValue();
+  return data_.b;
 }
 
 int JsonValue::asInt() const {
   if (!isInt()) throw type_error(type_, JsonType::Int);
-  auto data = static_cast<JsonNumber *>(data_.get());
-  return data->getInt();
+  return data_.i;
 }
 
 int64_t JsonValue::asLong() const {
-  auto data = static_cast<JsonNumber *>(data_.get());
   if (isLong()) {
-    return data->getInt64();
+    return data_.i64;
   } else if (isInt()) {
-    return data->getInt();
+    return data_.i;
   }
   throw type_error(type_, JsonType::Long);
 }
 
 double JsonValue::asDouble() const {
-  auto data = static_cast<JsonNumber *>(data_.get());
   if (isDouble()) {
-    return data->getDouble();
+    return data_.d;
   } else if (isInt()) {
-    return data->getInt();
+    return data_.i;
   }
   throw type_error(type_, JsonType::Double);
 }
 
 const std::string &JsonValue::asString() const {
   if (!isString()) throw type_error(type_, JsonType::String);
-  auto data = static_cast<JsonString *>(data_.get());
+  auto data = static_cast<JsonString *>(data_.ptr);
   return data->getValue();
 }
 
-const std::vector<JsonValue> &JsonValue::asArray() const {
+const JsonList &JsonValue::asArray() const {
   if (!isArray()) throw type_error(type_, JsonType::Array);
-  auto data = static_cast<JsonArray *>(data_.get());
+  auto data = static_cast<JsonArray *>(data_.ptr);
   return data->getValue();
 }
 
@@ -384,6 +285,82 @@ const JsonValue &JsonValue::asObject() const {
   return *this;
 }
 
+bool JsonValue::isPacked() const {
+  return isArray() && static_cast<JsonArray *>(data_.ptr)->isPacked();
+}
+
+JsonType JsonValue::packedType() const {
+  return isPacked() ? static_cast<JsonArray *>(data_.ptr)->packedType() : JsonType::Null;
+}
+
+bool JsonValue::pack() {
+  if (!isArray()) throw type_error("pack() can only be used by array type");
+  detach();
+  return static_cast<JsonArray *>(data_.ptr)->pack();
+}
+
+void JsonValue::share() {
+  if (type_ != JsonType::String && type_ != JsonType::Array && type_ != JsonType::Object) {
+    return;
+  }
+  // the nodes below a shared one could only be changed by copying it
+  if (data_.ptr->inArena() || !data_.ptr->unique()) {
+    return;
+  }
+  data_.ptr->setShareable();
+  if (isArray()) {
+    auto &data = *static_cast<JsonArray *>(data_.ptr);
+    if (!data.isPacked()) {
+      for (auto &item: data.getRef()) {
+        item.share();
+      }
+    }
+  } else if (isObject()) {
+    auto &values = static_cast<JsonObject *>(data_.ptr)->getValuesRef();
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      values[i].share();
+    }
+  }
+}
+
+bool JsonValue::isShareable() const {
+  return (isString() || isArray() || isObject()) && data_.ptr->shareable();
+}
+
+JsonFrozen JsonValue::freeze() const {
+  return JsonFrozen(*this);
+}
+
+JsonSpan<int64_t> JsonValue::asInt64Span() const {
+  if (!isArray()) throw type_error(type_, JsonType::Array);
+  const auto &data = *static_cast<JsonArray *>(data_.ptr);
+  if (data.empty()) return JsonSpan<int64_t>();
+  if (data.packedType() != JsonType::Int && data.packedType() != JsonType::Long) {
+    throw type_error("asInt64Span() can only be used by packed arrays of integers");
+  }
+  return JsonSpan<int64_t>(static_cast<const int64_t *>(data.packedData()), data.size());
+}
+
+JsonSpan<double> JsonValue::asDoubleSpan() const {
+  if (!isArray()) throw type_error(type_, JsonType::Array);
+  const auto &data = *static_cast<JsonArray *>(data_.ptr);
+  if (data.empty()) return JsonSpan<double>();
+  if (data.packedType() != JsonType::Double) {
+    throw type_error("asDoubleSpan() can only be used by packed arrays of doubles");
+  }
+  return JsonSpan<double>(static_cast<const double *>(data.packedData()), data.size());
+}
+
+JsonSpan<bool> JsonValue::asBoolSpan() const {
+  if (!isArray()) throw type_error(type_, JsonType::Array);
+  const auto &data = *static_cast<JsonArray *>(data_.ptr);
+  if (data.empty()) return JsonSpan<bool>();
+  if (data.packedType() != JsonType::Boolean) {
+    throw type_error("asBoolSpan() can only be used by packed arrays of booleans");
+  }
+  return JsonSpan<bool>(static_cast<const bool *>(data.packedData()), data.size());
+}
+
 JsonValue::operator bool() const {
   return asBoolean();
 }
@@ -410,7 +387,8 @@ JsonValue &JsonValue::operator[](const std::string &key) {
   } else if (!isObject()) {
     throw type_error("operator[](std::string) can only be used by object type");
   }
-  auto &data = *static_cast<JsonObject *>(data_.get());
+  leak();
+  auto &data = *static_cast<JsonObject *>(data_.ptr);
   return data[key];
 }
 
@@ -420,43 +398,46 @@ JsonValue &JsonValue::operator[](const char *key) {
   } else if (!isObject()) {
     throw type_error("operator[](char *) can only be used by object type");
   }
-  auto &data = *static_cast<JsonObject *>(data_.get());
+  leak();
+  auto &data = *static_cast<JsonObject *>(data_.ptr);
   return data[key];
 }
 
 const JsonValue &JsonValue::operator[](const std::string &key) const {
   if (!isObject()) throw type_error("operator[](std::string) can only be used by object type");
-  const auto &data = *static_cast<JsonObject *>(data_.get());
+  const auto &data = *static_cast<JsonObject *>(data_.ptr);
   return data[key];
 }
 
 const JsonValue &JsonValue::operator[](const char *key) const {
   if (!isObject()) throw type_error("operator[](char *) can only be used by object type");
-  const auto &data = *static_cast<JsonObject *>(data_.get());
+  const auto &data = *static_cast<JsonObject *>(data_.ptr);
   return data[key];
 }
 
 JsonValue &JsonValue::operator[](std::size_t index) {
   if (!isArray()) throw type_error("operator[](std::size_t) can only be used by array type");
-  auto &data = *static_cast<JsonArray *>(data_.get());
+  leak();
+  auto &data = *static_cast<JsonArray *>(data_.ptr);
   return data[index];
 }
 
 JsonValue &JsonValue::operator[](int index) {
   if (!isArray()) throw type_error("operator[](int) can only be used by array type");
-  auto &data = *static_cast<JsonArray *>(data_.get());
+  leak();
+  auto &data = *static_cast<JsonArray *>(data_.ptr);
   return data[index];
 }
 
 const JsonValue &JsonValue::operator[](std::size_t index) const {
   if (!isArray()) throw type_error("operator[](std::size_t) can only be used by array type");
-  const auto &data = *static_cast<JsonArray *>(data_.get());
+  const auto &data = *static_cast<JsonArray *>(data_.ptr);
   return data[index];
 }
 
 const JsonValue &JsonValue::operator[](int index) const {
   if (!isArray()) throw type_error("operator[](int) can only be used by array type");
-  const auto &data = *static_cast<JsonArray *>(data_.get());
+  const auto &data = *static_cast<JsonArray *>(data_.ptr);
   return data[index];
 }
 
@@ -470,9 +451,9 @@ std::size_t JsonValue::size() const {
     case JsonType::String:
       return 0;
     case JsonType::Array:
-      return static_cast<JsonArray *>(data_.get())->size();
+      return static_cast<JsonArray *>(data_.ptr)->size();
     case JsonType::Object:
-      return static_cast<JsonObject *>(data_.get())->size();
+      return static_cast<JsonObject *>(data_.ptr)->size();
   }
   return 0;
 }
@@ -487,42 +468,44 @@ bool JsonValue::empty() const {
     case JsonType::String:
       throw type_error("empty() can only be used by array or object type");
     case JsonType::Array:
-      return static_cast<JsonArray *>(data_.get())->empty();
+      return static_cast<JsonArray *>(data_.ptr)->empty();
     case JsonType::Object:
-      return static_cast<JsonObject *>(data_.get())->empty();
+      return static_cast<JsonObject *>(data_.ptr)->empty();
   }
   return true;
 }
 
 JsonIterator JsonValue::begin() {
+  leak();
   if (isArray()) {
-    auto &data = *static_cast<JsonArray *>(data_.get());
+    auto &data = *static_cast<JsonArray *>(data_.ptr);
     return JsonIterator(data.begin());
   } else if (isObject()) {
-    auto &data = *static_cast<JsonObject *>(data_.get());
-    return JsonIterator(data.begin());
+    auto &data = *static_cast<JsonObject *>(data_.ptr);
+    return objectIterator(data, 0);
   }
   return JsonIterator(*this);
 }
 
 JsonConstIterator JsonValue::begin() const {
   if (isArray()) {
-    const auto &data = *static_cast<JsonArray *>(data_.get());
+    const auto &data = *static_cast<JsonArray *>(data_.ptr);
     return JsonConstIterator(data.begin());
   } else if (isObject()) {
-    const auto &data = *static_cast<JsonObject *>(data_.get());
-    return JsonConstIterator(data.begin());
+    const auto &data = *static_cast<JsonObject *>(data_.ptr);
+    return objectIterator(data, 0);
   }
   return JsonConstIterator(*this);
 }
 
 JsonIterator JsonValue::end() {
+  leak();
   if (isArray()) {
-    auto &data = *static_cast<JsonArray *>(data_.get());
+    auto &data = *static_cast<JsonArray *>(data_.ptr);
     return JsonIterator(data.end());
   } else if (isObject()) {
-    auto &data = *static_cast<JsonObject *>(data_.get());
-    return JsonIterator(data.end());
+    auto &data = *static_cast<JsonObject *>(data_.ptr);
+    return objectIterator(data, data.size());
   }
   return JsonIterator(type_);
 }
@@ -530,30 +513,32 @@ JsonIterator JsonValue::end() {
 
 JsonConstIterator JsonValue::end() const {
   if (isArray()) {
-    const auto &data = *static_cast<JsonArray *>(data_.get());
+    const auto &data = *static_cast<JsonArray *>(data_.ptr);
     return JsonConstIterator(data.end());
   } else if (isObject()) {
-    const auto &data = *static_cast<JsonObject *>(data_.get());
-    return JsonConstIterator(data.end());
+    const auto &data = *static_cast<JsonObject *>(data_.ptr);
+    return objectIterator(data, data.size());
   }
   return JsonConstIterator(type_);
 }
 
 JsonIterator JsonValue::find(const std::string &key) {
   if (!isObject()) throw type_error("find(std::string) can only be used by object type");
-  auto &data = *static_cast<JsonObject *>(data_.get());
-  return JsonIterator(data.find(key));
+  leak();
+  auto &data = *static_cast<JsonObject *>(data_.ptr);
+  return objectIterator(data, data.find(key));
 }
 
 JsonConstIterator JsonValue::find(const std::string &key) const {
   if (!isObject()) throw type_error("find(std::string) can only be used by object type");
-  const auto &data = *static_cast<JsonObject *>(data_.get());
-  return JsonConstIterator(data.find(key));
+  const auto &data = *static_cast<JsonObject *>(data_.ptr);
+  return objectIterator(data, data.find(key));
 }
 
 JsonIterator JsonValue::at(std::size_t index) {
   if (!isArray()) throw type_error("at(std::size_t) can only be used by array type");
-  auto &data = *static_cast<JsonArray *>(data_.get());
+  leak();
+  auto &data = *static_cast<JsonArray *>(data_.ptr);
   if (index >= data.size()) {
     return JsonIterator(data.end());
   }
@@ -564,7 +549,7 @@ JsonIterator JsonValue::at(std::size_t index) {
 
 JsonConstIterator JsonValue::at(std::size_t index) const {
   if (!isArray()) throw type_error("at(std::size_t) can only be used by array type");
-  const auto &data = *static_cast<JsonArray *>(data_.get());
+  const auto &data = *static_cast<JsonArray *>(data_.ptr);
   if (index >= data.size()) {
     return JsonConstIterator(data.end());
   }
@@ -574,18 +559,18 @@ JsonConstIterator JsonValue::at(std::size_t index) const {
 }
 
 void JsonValue::reset() {
+  release();
   type_ = JsonType::Null;
-  data_.reset(nullptr);
 }
 
 void JsonValue::clear() {
+  detach();
   if (isArray()) {
-    static_cast<JsonArray *>(data_.get())->clear();
+    static_cast<JsonArray *>(data_.ptr)->clear();
   } else if (isObject()) {
-    static_cast<JsonObject *>(data_.get())->clear();
+    static_cast<JsonObject *>(data_.ptr)->clear();
   } else {
-    type_ = JsonType::Null;
-    data_.reset(nullptr);
+    reset();
   }
 }
 
@@ -595,7 +580,8 @@ bool JsonValue::push_back(const std::string &key, const JsonValue &value) {
   } else if (!isObject()) {
     throw type_error("push_back(std::string, JsonValue) can only be used by object type");
   }
-  auto &data = *static_cast<JsonObject *>(data_.get());
+  detach();
+  auto &data = *static_cast<JsonObject *>(data_.ptr);
   return data.insert(key, value);
 }
 
@@ -605,7 +591,8 @@ bool JsonValue::push_back(const std::string &key, JsonValue &&value) {
   } else if (!isObject()) {
     throw type_error("push_back(std::string, JsonValue) can only be used by object type");
   }
-  auto &data = *static_cast<JsonObject *>(data_.get());
+  detach();
+  auto &data = *static_cast<JsonObject *>(data_.ptr);
   return data.insert(key, std::move(value));
 }
 
@@ -615,7 +602,8 @@ void JsonValue::push_back(const JsonValue &value) {
   } else if (!isArray()) {
     throw type_error("push_back(JsonValue) can only be used by array type");
   }
-  auto &data = *static_cast<JsonArray *>(data_.get());
+  detach();
+  auto &data = *static_cast<JsonArray *>(data_.ptr);
   data.push_back(value);
 }
 
@@ -625,7 +613,8 @@ void JsonValue::push_back(JsonValue &&value) {
   } else if (!isArray()) {
     throw type_error("push_back(JsonValue) can only be used by array type");
   }
-  auto &data = *static_cast<JsonArray *>(data_.get());
+  detach();
+  auto &data = *static_cast<JsonArray *>(data_.ptr);
   data.push_back(std::move(value));
 }
 
@@ -633,90 +622,166 @@ JsonIterator JsonValue::insert(JsonConstIterator pos, const JsonValue &value) {
   if (!isArray())
     throw type_error("insert(JsonConstIterator,JsonValue) can only be used by array type");
   if (pos.type_ != type_) throw type_error("Insert type mismatch");
-  auto &data = *static_cast<JsonArray *>(data_.get());
-  return JsonIterator(data.insert(pos.array_iter_, value));
+  auto offset = pos.array_iter_ - static_cast<JsonArray *>(data_.ptr)->getValue().begin();
+  leak();
+  auto &data = *static_cast<JsonArray *>(data_.ptr);
+  return JsonIterator(data.insert(data.begin() + offset, value));
 }
 
 JsonIterator JsonValue::insert(JsonConstIterator pos, JsonValue &&value) {
   if (!isArray())
     throw type_error("insert(JsonConstIterator,JsonValue) can only be used by array type");
   if (pos.type_ != type_) throw type_error("Insert type mismatch");
-  auto &data = *static_cast<JsonArray *>(data_.get());
-  return JsonIterator(data.insert(pos.array_iter_, std::move(value)));
+  auto offset = pos.array_iter_ - static_cast<JsonArray *>(data_.ptr)->getValue().begin();
+  leak();
+  auto &data = *static_cast<JsonArray *>(data_.ptr);
+  return JsonIterator(data.insert(data.begin() + offset, std::move(value)));
 }
 
 JsonIterator JsonValue::erase(JsonConstIterator pos) {
   if (pos.type_ != type_) throw type_error("Erase type mismatch");
+  // pos may belong to the node shared before detach
   if (isArray()) {
-    auto &data = *static_cast<JsonArray *>(data_.get());
-    return JsonIterator(data.erase(pos.array_iter_));
+    auto offset = pos.array_iter_ - static_cast<JsonArray *>(data_.ptr)->getValue().begin();
+    leak();
+    auto &data = *static_cast<JsonArray *>(data_.ptr);
+    return JsonIterator(data.erase(data.begin() + offset));
   } else if (isObject()) {
-    auto &data = *static_cast<JsonObject *>(data_.get());
-    return JsonIterator(data.erase(pos.object_iter_));
+    leak();
+    auto &data = *static_cast<JsonObject *>(data_.ptr);
+    data.erase(pos.pos_);
+    return objectIterator(data, pos.pos_);
   }
   throw type_error("erase(JsonConstIterator) can only be used by array or object type");
 }
 
 bool JsonValue::erase(const std::string &key) {
   if (!isObject()) throw type_error("erase(std::string) can only be used by object type");
-  auto &data = *static_cast<JsonObject *>(data_.get());
+  detach();
+  auto &data = *static_cast<JsonObject *>(data_.ptr);
   return data.erase(key) != 0;
 }
 
 bool JsonValue::isMember(const std::string &key) const {
   if (!isObject()) throw type_error("isMember(std::string) can only be used by object type");
-  const auto &data = *static_cast<JsonObject *>(data_.get());
-  return data.find(key) != data.end();
+  const auto &data = *static_cast<JsonObject *>(data_.ptr);
+  return data.find(key) != data.size();
 }
 
 bool JsonValue::removeMember(const std::string &key) {
   if (!isObject()) throw type_error("removeMember(std::string) can only be used by object type");
-  auto &data = *static_cast<JsonObject *>(data_.get());
+  detach();
+  auto &data = *static_cast<JsonObject *>(data_.ptr);
   return data.erase(key) != 0;
 }
 
 std::string JsonValue::toString() const {
-  if (isNull()) {
-    static const std::string null("null");
-    return null;
+  if (isString()) {
+    return asString();
   }
-  return data_->toString();
+  std::string out;
+  dump(out);
+  return out;
 }
 
-std::ostream &JsonValue::toDumpStream(std::ostream &out) const {
-  if (isNull()) {
-    out << "null";
-    return out;
+void JsonValue::dump(std::string &out) const {
+  char buf[kNumberBufferSize];
+  switch (type_) {
+    case JsonType::Null:
+      out.append("null", 4);
+      break;
+    case JsonType::Boolean:
+      if (data_.b) {
+        out.append("true", 4);
+      } else {
+        out.append("false", 5);
+      }
+      break;
+    case JsonType::Int:
+      out.append(buf, writeInt64(data_.i, buf));
+      break;
+    case JsonType::Long:
+      out.append(buf, writeInt64(data_.i64, buf));
+      break;
+    case JsonType::Double:
+      out.append(buf, writeDouble(data_.d, buf));
+      break;
+    case JsonType::String:
+    case JsonType::Array:
+    case JsonType::Object:
+      data_.ptr->dump(out);
+      break;
   }
-  return data_->toDumpStream(out);
+}
+
+std::ostream &JsonValue::toDumpStream(std::ostream &out) const {
+  std::string buf;
+  dump(buf);
+  return out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
 }
 
 std::ostream &operator<<(std::ostream &out, const JsonValue &value) {
   return value.toDumpStream(out);
 }
 
-#if __cplusplus < 201402L
 void JsonValue::setToObject() {
+  release();
   type_ = JsonType::Object;
-  data_ = std::unique_ptr<JsonObject>(new JsonObject());
+  data_.ptr = new JsonObject();
 }
 
 void JsonValue::setToArray() {
-  type_ = JsonType::Object;
-  data_ = std::unique_ptr<JsonArray>(new JsonArray());
+  release();
+  type_ = JsonType::Array;
+  data_.ptr = new JsonArray();
 }
-#else
 
-void JsonValue::setToObject() {
-  type_ = JsonType::Object;
-  data_ = std::make_unique<JsonObject>();
+void JsonValue::release() {
+  switch (type_) {
+    case JsonType::String:
+    case JsonType::Array:
+    case JsonType::Object:
+      if (!data_.ptr->inArena() && data_.ptr->unref()) {
+        delete data_.ptr;
+      }
+      break;
+    default:
+      break;
+  }
 }
 
-void JsonValue::setToArray() {
-  type_ = JsonType::Object;
-  data_ = std::make_unique<JsonArray>();
+void JsonValue::detach() {
+  switch (type_) {
+    case JsonType::String:
+    case JsonType::Array:
+    case JsonType::Object:
+      if (!data_.ptr->unique()) {
+        JsonBase *node = cloneNode();
+        release();
+        data_.ptr = node;
+      }
+      break;
+    default:
+      break;
+  }
 }
 
-#endif
+void JsonValue::leak() {
+  detach();
+  if (type_ == JsonType::Array || type_ == JsonType::Object) {
+    data_.ptr->setShareable(false);
+  }
+}
+
+JsonBase *JsonValue::cloneNode() const {
+  switch (type_) {
+    case JsonType::String:
+      return new JsonString(*static_cast<JsonString *>(data_.ptr));
+    case JsonType::Array:
+      return new JsonArray(*static_cast<JsonArray *>(data_.ptr));
+    default:
+      return new JsonObject(*static_cast<JsonObject *>(data_.ptr));
+  }
+}
 
 } // suger
\ No newline at end of file
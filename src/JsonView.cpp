@@ -0,0 +1,422 @@
+// Copyright (c) 2023. SugerSalt
+
+#include "JsonView.hpp"
+#include <cstring>
+#include "JsonError.hpp"
+#include "JsonReader.hpp"
+#include "detail/number.hpp"
+#include "detail/scan.hpp"
+#include "detail/tool.hpp"
+
+namespace suger {
+
+namespace {
+
+// Position after the string which starts at pos, its characters are appended to str unless
+// it is nullptr. Errors are the same as in JsonReader::getString.
+const char *scanString(const char *begin, const char *pos, const char *end, std::string *str) {
+  const char *it = pos + 1;
+  while (true) {
+    const char *special = detail::findStringSpecial(it, end);
+    if (str) {
+      str->append(it, special);
+    }
+    it = special;
+    if (it == end) {
+      throwParseError("Syntax error: incomplete string.", begin, pos);
+    }
+    char ch = *it;
+    if (ch == '\"') {
+      return it + 1;
+    } else if (ch == '\\') {
+      if (++it == end) {
+        throwParseError("Syntax error: incomplete string.", begin, pos);
+      }
+      ch = getTranslatedChar(*it);
+    } else if (ch == '\n') {
+      throwParseError("Syntax error: incomplete string.", begin, pos);
+    }
+    if (str) {
+      *str += ch;
+    }
+    ++it;
+  }
+}
+
+void checkLiteral(const char *begin, const char *pos, const char *end, const char *literal,
+                  std::size_t len) {
+  if (static_cast<std::size_t>(end - pos) < len || std::memcmp(pos, literal, len) != 0) {
+    throwParseError("Syntax error: value, object or array expected.", begin, pos);
+  }
+}
+
+// The value read ends at pos, only the end of its object or array or of the text may follow,
+// like JsonReader requires.
+void checkValueEnd(const char *begin, const char *pos, const char *end) {
+  pos = detail::skipBlank(pos, end);
+  if (pos != end && *pos != ',' && *pos != '}' && *pos != ']') {
+    throwParseError("Syntax error: unexpected character after the value.", begin, pos);
+  }
+}
+
+const char *skipDigits(const char *pos, const char *end) {
+  while (pos != end && *pos >= '0' && *pos <= '9') {
+    ++pos;
+  }
+  return pos;
+}
+
+// the same text as detail::scanNumber reads
+const char *skipNumber(const char *pos, const char *end) {
+  pos = skipDigits(pos + 1, end);
+  if (pos != end && *pos == '.') {
+    pos = skipDigits(pos + 1, end);
+  }
+  if (pos != end && (*pos == 'e' || *pos == 'E')) {
+    ++pos;
+    if (pos != end && (*pos == '+' || *pos == '-')) {
+      ++pos;
+    }
+    pos = skipDigits(pos, end);
+  }
+  return pos;
+}
+
+// Only strings are looked into, the brackets are counted without checking that they match.
+const char *skipContainer(const char *begin, const char *pos, const char *end) {
+  std::size_t depth = 0;
+  for (const char *it = pos; it != end;) {
+    switch (*it) {
+      case '\"':
+        it = scanString(begin, it, end, nullptr);
+        continue;
+      case '{':
+      case '[':
+        ++depth;
+        break;
+      case '}':
+      case ']':
+        if (--depth == 0) {
+          return it + 1;
+        }
+        break;
+      default:
+        break;
+    }
+    ++it;
+  }
+  throwParseError(*pos == '{' ? "Syntax error: missing ',' or '}' in object declaration"
+                              : "Syntax error: missing ',' or ']' in array declaration",
+                  begin, end);
+}
+
+const char *skipValue(const char *begin, const char *pos, const char *end) {
+  if (pos != end) {
+    switch (*pos) {
+      case '{':
+      case '[':
+        return skipContainer(begin, pos, end);
+      case '\"':
+        return scanString(begin, pos, end, nullptr);
+      case 't':
+      case 'n':
+        checkLiteral(begin, pos, end, *pos == 't' ? "true" : "null", 4);
+        return pos + 4;
+      case 'f':
+        checkLiteral(begin, pos, end, "false", 5);
+        return pos + 5;
+      case '+':
+      case '-':
+        return skipNumber(pos, end);
+      default:
+        if (*pos >= '0' && *pos <= '9') {
+          return skipNumber(pos, end);
+        }
+        break;
+    }
+  }
+  throwParseError("Syntax error: value, object or array expected.", begin, pos);
+}
+
+} // namespace
+
+JsonView::JsonView(const char *text) : JsonView(text, std::strlen(text)) {
+
+}
+
+JsonView::JsonView(const char *text, std::size_t length)
+    : begin_(text), pos_(detail::skipBlank(text, text + length)), end_(text + length) {
+
+}
+
+JsonView::JsonView(const std::string &text) : JsonView(text.data(), text.size()) {
+
+}
+
+JsonView::JsonView(const char *begin, const char *pos, const char *end)
+    : begin_(begin), pos_(pos), end_(end) {
+
+}
+
+JsonType JsonView::getType() const {
+  if (pos_ != end_) {
+    switch (*pos_) {
+      case '{':
+        return JsonType::Object;
+      case '[':
+        return JsonType::Array;
+      case '\"':
+        return JsonType::String;
+      case 't':
+        checkLiteral(begin_, pos_, end_, "true", 4);
+        checkValueEnd(begin_, pos_ + 4, end_);
+        return JsonType::Boolean;
+      case 'f':
+        checkLiteral(begin_, pos_, end_, "false", 5);
+        checkValueEnd(begin_, pos_ + 5, end_);
+        return JsonType::Boolean;
+      case 'n':
+        checkLiteral(begin_, pos_, end_, "null", 4);
+        checkValueEnd(begin_, pos_ + 4, end_);
+        return JsonType::Null;
+      default:
+        break;
+    }
+    detail::ParsedNumber number;
+    if (readNumber(number)) {
+      return number.type;
+    }
+  }
+  throwParseError("Syntax error: value, object or array expected.", begin_, pos_);
+}
+
+bool JsonView::isNull() const {
+  return getType() == JsonType::Null;
+}
+
+bool JsonView::isBoolean() const {
+  return getType() == JsonType::Boolean;
+}
+
+bool JsonView::isNumber() const {
+  JsonType type = getType();
+  return type == JsonType::Int || type == JsonType::Long || type == JsonType::Double;
+}
+
+bool JsonView::isInt() const {
+  return getType() == JsonType::Int;
+}
+
+bool JsonView::isLong() const {
+  return getType() == JsonType::Long;
+}
+
+bool JsonView::isDouble() const {
+  return getType() == JsonType::Double;
+}
+
+bool JsonView::isString() const {
+  return getType() == JsonType::String;
+}
+
+bool JsonView::isArray() const {
+  return getType() == JsonType::Array;
+}
+
+bool JsonView::isObject() const {
+  return getType() == JsonType::Object;
+}
+
+bool JsonView::asBoolean() const {
+  JsonType type = getType();
+  if (type != JsonType::Boolean) throw type_error(type, JsonType::Boolean);
+  return *pos_ == 't';
+}
+
+int JsonView::asInt() const {
+  detail::ParsedNumber number;
+  if (!readNumber(number) || number.type != JsonType::Int) {
+    throw type_error(getType(), JsonType::Int);
+  }
+  return number.i;
+}
+
+int64_t JsonView::asLong() const {
+  detail::ParsedNumber number;
+  if (readNumber(number)) {
+    if (number.type == JsonType::Long) {
+      return number.i64;
+    } else if (number.type == JsonType::Int) {
+      return number.i;
+    }
+  }
+  throw type_error(getType(), JsonType::Long);
+}
+
+double JsonView::asDouble() const {
+  detail::ParsedNumber number;
+  if (readNumber(number)) {
+    if (number.type == JsonType::Double) {
+      return number.d;
+    } else if (number.type == JsonType::Int) {
+      return number.i;
+    }
+  }
+  throw type_error(getType(), JsonType::Double);
+}
+
+std::string JsonView::asString() const {
+  JsonType type = getType();
+  if (type != JsonType::String) throw type_error(type, JsonType::String);
+  std::string str;
+  checkValueEnd(begin_, scanString(begin_, pos_, end_, &str), end_);
+  return str;
+}
+
+JsonView JsonView::operator[](const std::string &key) const {
+  if (!isObject()) throw type_error("operator[](std::string) can only be used by object type");
+  const char *value = findMember(key.data(), key.size());
+  if (!value) throw key_error(key);
+  return JsonView(begin_, value, end_);
+}
+
+JsonView JsonView::operator[](const char *key) const {
+  if (!isObject()) throw type_error("operator[](char *) can only be used by object type");
+  const char *value = findMember(key, std::strlen(key));
+  if (!value) throw key_error(key);
+  return JsonView(begin_, value, end_);
+}
+
+JsonView JsonView::operator[](std::size_t index) const {
+  if (!isArray()) throw type_error("operator[](std::size_t) can only be used by array type");
+  const char *value = findElement(index);
+  if (!value) throw key_error(std::to_string(index));
+  return JsonView(begin_, value, end_);
+}
+
+JsonView JsonView::operator[](int index) const {
+  if (!isArray()) throw type_error("operator[](int) can only be used by array type");
+  const char *value = index < 0 ? nullptr : findElement(static_cast<std::size_t>(index));
+  if (!value) throw key_error(std::to_string(index));
+  return JsonView(begin_, value, end_);
+}
+
+bool JsonView::isMember(const std::string &key) const {
+  if (!isObject()) throw type_error("isMember(std::string) can only be used by object type");
+  return findMember(key.data(), key.size()) != nullptr;
+}
+
+std::size_t JsonView::size() const {
+  JsonType type = getType();
+  if (type != JsonType::Object && type != JsonType::Array) {
+    return 0;
+  }
+  std::size_t count = 0;
+  bool match;
+  for (const char *pos = firstItem(); pos; ++count) {
+    if (type == JsonType::Object) {
+      pos = readKey(pos, nullptr, 0, match);
+    }
+    pos = nextItem(pos);
+  }
+  return count;
+}
+
+std::string JsonView::text() const {
+  const char *value_end = skipValue(begin_, pos_, end_);
+  checkValueEnd(begin_, value_end, end_);
+  return std::string(pos_, value_end);
+}
+
+JsonValue JsonView::toValue() const {
+  JsonReader reader;
+  reader.reset(begin_, end_);
+  reader.pos_ = pos_;
+  JsonValue json;
+  reader.readDom(json);
+  checkValueEnd(begin_, reader.pos_, end_);
+  return json;
+}
+
+bool JsonView::readNumber(detail::ParsedNumber &number) const {
+  if (pos_ == end_) {
+    return false;
+  }
+  char ch = *pos_;
+  if ((ch < '0' || ch > '9') && ch != '+' && ch != '-') {
+    return false;
+  }
+  checkValueEnd(begin_, detail::scanNumber(pos_, end_, number), end_);
+  return true;
+}
+
+const char *JsonView::findMember(const char *key, std::size_t length) const {
+  bool match;
+  for (const char *pos = firstItem(); pos; ) {
+    pos = readKey(pos, key, length, match);
+    if (match) {
+      return pos;
+    }
+    pos = nextItem(pos);
+  }
+  return nullptr;
+}
+
+const char *JsonView::findElement(std::size_t index) const {
+  const char *pos = firstItem();
+  for (std::size_t i = 0; pos && i != index; ++i) {
+    pos = nextItem(pos);
+  }
+  return pos;
+}
+
+const char *JsonView::firstItem() const {
+  const char *pos = detail::skipBlank(pos_ + 1, end_);
+  if (pos != end_ && *pos == (*pos_ == '{' ? '}' : ']')) {
+    return nullptr;
+  }
+  return pos;
+}
+
+const char *JsonView::nextItem(const char *pos) const {
+  bool object = *pos_ == '{';
+  pos = detail::skipBlank(skipValue(begin_, pos, end_), end_);
+  if (pos != end_) {
+    if (*pos == ',') {
+      return detail::skipBlank(pos + 1, end_);
+    } else if (*pos == (object ? '}' : ']')) {
+      return nullptr;
+    }
+  }
+  throwParseError(object ? "Syntax error: missing ',' or '}' in object declaration"
+                         : "Syntax error: missing ',' or ']' in array declaration",
+                  begin_, pos);
+}
+
+const char *JsonView::readKey(const char *pos, const char *key, std::size_t length,
+                              bool &match) const {
+  if (pos == end_ || *pos != '\"') {
+    throwParseError("Syntax error: key should be a string.", begin_, pos);
+  }
+  const char *key_end = scanString(begin_, pos, end_, nullptr);
+  match = false;
+  if (key) {
+    const char *first = pos + 1;
+    const char *last = key_end - 1;
+    if (!std::memchr(first, '\\', static_cast<std::size_t>(last - first))) {
+      match = static_cast<std::size_t>(last - first) == length &&
+              std::memcmp(first, key, length) == 0;
+    } else {
+      std::string name;
+      scanString(begin_, pos, end_, &name);
+      match = name.size() == length && std::memcmp(name.data(), key, length) == 0;
+    }
+  }
+  pos = detail::skipBlank(key_end, end_);
+  if (pos == end_ || *pos != ':') {
+    throwParseError("Syntax error: missing ':' after object member name.", begin_, pos);
+  }
+  return detail::skipBlank(pos + 1, end_);
+}
+
+} // suger
@@ -0,0 +1,36 @@
+// Copyright (c) 2023. SugerSalt
+
+#include "allocation.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<std::size_t> allocations(0);
+
+} // namespace
+
+void *operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+namespace bench {
+
+std::size_t allocationCount() {
+  return allocations.load(std::memory_order_relaxed);
+}
+
+} // bench
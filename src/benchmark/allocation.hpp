@@ -0,0 +1,16 @@
+// Copyright (c) 2023. SugerSalt
+
+#ifndef SUGERJSON_BENCHMARK_ALLOCATION_HPP
+#define SUGERJSON_BENCHMARK_ALLOCATION_HPP
+
+#include <cstddef>
+
+namespace bench {
+
+// Number of calls to operator new so far. Linking allocation.cpp replaces the global
+// operator new, so the allocations made inside the library are counted as well.
+std::size_t allocationCount();
+
+} // bench
+
+#endif //SUGERJSON_BENCHMARK_ALLOCATION_HPP
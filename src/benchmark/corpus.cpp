@@ -0,0 +1,318 @@
+// Copyright (c) 2023. SugerSalt
+
+#include "corpus.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+namespace bench {
+
+namespace {
+
+// appends json text, commas between members are inserted by the caller
+class Writer {
+public:
+  std::string out;
+
+  void key(const std::string &name) {
+    str(name);
+    out += ':';
+  }
+  void str(const std::string &value) {
+    out += '\"';
+    for (char ch: value) {
+      if (ch == '\"' || ch == '\\') {
+        out += '\\';
+        out += ch;
+      } else if (ch == '\n') {
+        out += "\\n";
+      } else {
+        out += ch;
+      }
+    }
+    out += '\"';
+  }
+  void num(int64_t value) {
+    out += std::to_string(value);
+  }
+  void dbl(double value, int precision) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.*f", precision, value);
+    out += buf;
+  }
+  void raw(const char *text) {
+    out += text;
+  }
+};
+
+const char *const kWords[] = {
+    "json", "parser", "fast", "value", "array", "object", "string", "number",
+    "today", "release", "benchmark", "\xe3\x81\x93\xe3\x82\x93\xe3\x81\xab\xe3\x81\xa1\xe3\x81\xaf",
+    "\xe4\xb8\x96\xe7\x95\x8c", "caf\xc3\xa9", "\"quoted\"", "line\nbreak", "#hashtag", "@mention"};
+
+std::string sentence(std::mt19937 &rng, int words) {
+  std::string text;
+  for (int i = 0; i < words; ++i) {
+    if (i != 0) {
+      text += ' ';
+    }
+    text += kWords[rng() % (sizeof(kWords) / sizeof(kWords[0]))];
+  }
+  return text;
+}
+
+std::string hexColor(std::mt19937 &rng) {
+  char buf[8];
+  std::snprintf(buf, sizeof(buf), "%06X", static_cast<unsigned>(rng() & 0xFFFFFF));
+  return buf;
+}
+
+} // namespace
+
+std::string generateCanada() {
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> jitter(-0.05, 0.05);
+  Writer w;
+  w.raw("{\"type\":\"FeatureCollection\",\"features\":[{\"type\":\"Feature\",");
+  w.raw("\"properties\":{\"name\":\"Canada\"},\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[");
+  for (int ring = 0; ring < 480; ++ring) {
+    if (ring != 0) {
+      w.out += ',';
+    }
+    w.out += '[';
+    double x = -140.0 + static_cast<double>(rng() % 8000) / 100.0;
+    double y = 42.0 + static_cast<double>(rng() % 3000) / 100.0;
+    int points = 20 + static_cast<int>(rng() % 200);
+    for (int i = 0; i < points; ++i) {
+      x += jitter(rng);
+      y += jitter(rng);
+      if (i != 0) {
+        w.out += ',';
+      }
+      w.out += '[';
+      w.dbl(x, 15);
+      w.out += ',';
+      w.dbl(y, 15);
+      w.out += ']';
+    }
+    w.out += ']';
+  }
+  w.raw("]}}]}");
+  return w.out;
+}
+
+std::string generateTwitter() {
+  std::mt19937 rng(2);
+  Writer w;
+  w.raw("{\"statuses\":[");
+  for (int i = 0; i < 100; ++i) {
+    if (i != 0) {
+      w.out += ',';
+    }
+    int64_t id = 505874924095815681LL + static_cast<int64_t>(rng() % 100000);
+    int64_t user_id = 1186275104LL + static_cast<int64_t>(rng() % 100000000);
+    w.raw("{\"metadata\":{\"result_type\":\"recent\",\"iso_language_code\":\"ja\"},");
+    w.key("created_at");
+    w.str("Sun Aug 31 00:29:15 +0000 2014");
+    w.raw(",\"id\":");
+    w.num(id);
+    w.raw(",\"id_str\":");
+    w.str(std::to_string(id));
+    w.raw(",\"text\":");
+    w.str(sentence(rng, 8 + static_cast<int>(rng() % 12)));
+    w.raw(",\"source\":");
+    w.str("<a href=\"http://twitter.com/download/iphone\" rel=\"nofollow\">Twitter for iPhone</a>");
+    w.raw(",\"truncated\":false,\"in_reply_to_status_id\":null,\"in_reply_to_status_id_str\":null,");
+    w.raw("\"in_reply_to_user_id\":null,\"in_reply_to_screen_name\":null,\"user\":{\"id\":");
+    w.num(user_id);
+    w.raw(",\"id_str\":");
+    w.str(std::to_string(user_id));
+    w.raw(",\"name\":");
+    w.str(sentence(rng, 2));
+    w.raw(",\"screen_name\":");
+    w.str("user_" + std::to_string(rng() % 100000));
+    w.raw(",\"location\":");
+    w.str(sentence(rng, 1));
+    w.raw(",\"description\":");
+    w.str(sentence(rng, 12));
+    w.raw(",\"url\":null,\"entities\":{\"description\":{\"urls\":[]}},\"protected\":false,");
+    w.raw("\"followers_count\":");
+    w.num(rng() % 10000);
+    w.raw(",\"friends_count\":");
+    w.num(rng() % 10000);
+    w.raw(",\"listed_count\":");
+    w.num(rng() % 100);
+    w.raw(",\"created_at\":\"Sun Mar 03 18:56:27 +0000 2013\",\"favourites_count\":");
+    w.num(rng() % 10000);
+    w.raw(",\"utc_offset\":null,\"time_zone\":null,\"geo_enabled\":false,\"verified\":false,");
+    w.raw("\"statuses_count\":");
+    w.num(rng() % 100000);
+    w.raw(",\"lang\":\"ja\",\"contributors_enabled\":false,\"is_translator\":false,");
+    w.raw("\"is_translation_enabled\":false,\"profile_background_color\":");
+    w.str(hexColor(rng));
+    w.raw(",\"profile_background_image_url\":"
+          "\"http://abs.twimg.com/images/themes/theme1/bg.png\","
+          "\"profile_background_image_url_https\":"
+          "\"https://abs.twimg.com/images/themes/theme1/bg.png\","
+          "\"profile_background_tile\":false,\"profile_image_url\":");
+    w.str("http://pbs.twimg.com/profile_images/" + std::to_string(rng()) + "/normal.jpeg");
+    w.raw(",\"profile_image_url_https\":");
+    w.str("https://pbs.twimg.com/profile_images/" + std::to_string(rng()) + "/normal.jpeg");
+    w.raw(",\"profile_link_color\":");
+    w.str(hexColor(rng));
+    w.raw(",\"profile_sidebar_border_color\":");
+    w.str(hexColor(rng));
+    w.raw(",\"profile_sidebar_fill_color\":\"DDEEF6\",\"profile_text_color\":\"333333\","
+          "\"profile_use_background_image\":true,\"default_profile\":true,"
+          "\"default_profile_image\":false,\"following\":false,\"follow_request_sent\":false,"
+          "\"notifications\":false},\"geo\":null,\"coordinates\":null,\"place\":null,"
+          "\"contributors\":null,\"retweet_count\":");
+    w.num(rng() % 1000);
+    w.raw(",\"favorite_count\":");
+    w.num(rng() % 1000);
+    w.raw(",\"entities\":{\"hashtags\":[],\"symbols\":[],\"urls\":[],\"user_mentions\":[");
+    int mentions = static_cast<int>(rng() % 3);
+    for (int m = 0; m < mentions; ++m) {
+      if (m != 0) {
+        w.out += ',';
+      }
+      int64_t mention_id = static_cast<int64_t>(rng());
+      w.raw("{\"screen_name\":");
+      w.str("user_" + std::to_string(rng() % 100000));
+      w.raw(",\"name\":");
+      w.str(sentence(rng, 2));
+      w.raw(",\"id\":");
+      w.num(mention_id);
+      w.raw(",\"id_str\":");
+      w.str(std::to_string(mention_id));
+      w.raw(",\"indices\":[");
+      w.num(m * 12);
+      w.out += ',';
+      w.num(m * 12 + 10);
+      w.raw("]}");
+    }
+    w.raw("]},\"favorited\":false,\"retweeted\":false,\"lang\":\"ja\"}");
+  }
+  w.raw("],\"search_metadata\":{\"completed_in\":0.087,\"max_id\":505874924095815681,"
+        "\"max_id_str\":\"505874924095815681\",\"next_results\":"
+        "\"?max_id=505874847260352512&q=%E4%B8%80&count=100&include_entities=1\","
+        "\"query\":\"%E4%B8%80\",\"refresh_url\":\"?since_id=505874924095815681&q=%E4%B8%80\","
+        "\"count\":100,\"since_id\":0,\"since_id_str\":\"0\"}}");
+  return w.out;
+}
+
+std::string generateCitm() {
+  std::mt19937 rng(3);
+  const int64_t kEventBase = 138586341;
+  const int64_t kAreaBase = 205705993;
+  const int64_t kTopicBase = 107888604;
+  const int64_t kCategoryBase = 338937235;
+  Writer w;
+
+  auto names = [&](const char *key, int64_t base, int count) {
+    w.key(key);
+    w.out += '{';
+    for (int i = 0; i < count; ++i) {
+      if (i != 0) {
+        w.out += ',';
+      }
+      w.key(std::to_string(base + i));
+      w.str(sentence(rng, 1 + static_cast<int>(rng() % 3)));
+    }
+    w.out += '}';
+  };
+
+  w.out += '{';
+  names("areaNames", kAreaBase, 17);
+  w.out += ',';
+  names("audienceSubCategoryNames", 337100890, 1);
+  w.raw(",\"blockNames\":{},\"events\":{");
+  for (int i = 0; i < 184; ++i) {
+    if (i != 0) {
+      w.out += ',';
+    }
+    w.key(std::to_string(kEventBase + i));
+    w.raw("{\"description\":null,\"id\":");
+    w.num(kEventBase + i);
+    w.raw(",\"logo\":");
+    if (rng() % 2) {
+      w.str("/images/UE0AAAAACEKo6QAAAAVDSVRN");
+    } else {
+      w.raw("null");
+    }
+    w.raw(",\"name\":");
+    w.str(sentence(rng, 3));
+    w.raw(",\"subTopicIds\":[");
+    for (int t = 0; t < 4; ++t) {
+      if (t != 0) {
+        w.out += ',';
+      }
+      w.num(kTopicBase + static_cast<int64_t>(rng() % 64));
+    }
+    w.raw("],\"subjectCode\":null,\"subtitle\":null,\"topicIds\":[");
+    w.num(kTopicBase + static_cast<int64_t>(rng() % 64));
+    w.out += ',';
+    w.num(kTopicBase + static_cast<int64_t>(rng() % 64));
+    w.raw("]}");
+  }
+  w.raw("},\"performances\":[");
+  for (int i = 0; i < 243; ++i) {
+    if (i != 0) {
+      w.out += ',';
+    }
+    w.raw("{\"eventId\":");
+    w.num(kEventBase + static_cast<int64_t>(rng() % 184));
+    w.raw(",\"id\":");
+    w.num(339887544 + i);
+    w.raw(",\"logo\":null,\"name\":null,\"prices\":[");
+    int prices = 1 + static_cast<int>(rng() % 5);
+    for (int p = 0; p < prices; ++p) {
+      if (p != 0) {
+        w.out += ',';
+      }
+      w.raw("{\"amount\":");
+      w.num(10000 + static_cast<int64_t>(rng() % 100000));
+      w.raw(",\"audienceSubCategoryId\":337100890,\"seatCategoryId\":");
+      w.num(kCategoryBase + p);
+      w.out += '}';
+    }
+    w.raw("],\"seatCategories\":[");
+    for (int c = 0; c < prices; ++c) {
+      if (c != 0) {
+        w.out += ',';
+      }
+      w.raw("{\"areas\":[");
+      int areas = 1 + static_cast<int>(rng() % 8);
+      for (int a = 0; a < areas; ++a) {
+        if (a != 0) {
+          w.out += ',';
+        }
+        w.raw("{\"areaId\":");
+        w.num(kAreaBase + static_cast<int64_t>(rng() % 17));
+        w.raw(",\"blockIds\":[]}");
+      }
+      w.raw("],\"seatCategoryId\":");
+      w.num(kCategoryBase + c);
+      w.out += '}';
+    }
+    w.raw("],\"seatMapImage\":null,\"start\":");
+    w.num(1372354200000LL + static_cast<int64_t>(rng() % 100000) * 1000);
+    w.raw(",\"venueCode\":\"PLEYEL_PLEYEL\"}");
+  }
+  w.raw("],");
+  names("seatCategoryNames", kCategoryBase, 64);
+  w.raw(",\"subTopicNames\":{},\"subjectNames\":{},");
+  names("topicNames", kTopicBase, 64);
+  w.raw(",\"topicSubTopics\":{},\"venueNames\":{\"PLEYEL_PLEYEL\":\"Salle Pleyel\"}}");
+  return w.out;
+}
+
+std::vector<Corpus> standardCorpora() {
+  std::vector<Corpus> corpora;
+  corpora.push_back({"canada", generateCanada()});
+  corpora.push_back({"twitter", generateTwitter()});
+  corpora.push_back({"citm", generateCitm()});
+  return corpora;
+}
+
+} // bench
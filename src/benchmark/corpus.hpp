@@ -0,0 +1,28 @@
+// Copyright (c) 2023. SugerSalt
+
+#ifndef SUGERJSON_BENCHMARK_CORPUS_HPP
+#define SUGERJSON_BENCHMARK_CORPUS_HPP
+
+#include <string>
+#include <vector>
+
+namespace bench {
+
+struct Corpus {
+  std::string name;
+  std::string text;
+};
+
+// Synthetic documents shaped like the usual json benchmark files, generated with a fixed seed.
+// canada: geometry, mostly arrays of doubles
+std::string generateCanada();
+// twitter: api responses, nested objects with many keys and utf-8 text
+std::string generateTwitter();
+// citm: event catalog, objects keyed by numeric strings and integer arrays
+std::string generateCitm();
+
+std::vector<Corpus> standardCorpora();
+
+} // bench
+
+#endif //SUGERJSON_BENCHMARK_CORPUS_HPP
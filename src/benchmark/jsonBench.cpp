@@ -0,0 +1,272 @@
+// Copyright (c) 2023. SugerSalt
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "JsonBinary.hpp"
+#include "JsonParallel.hpp"
+#include "JsonReader.hpp"
+#include "JsonStreamReader.hpp"
+#include "JsonView.hpp"
+#include "allocation.hpp"
+#include "corpus.hpp"
+
+using namespace std;
+using suger::JsonValue;
+
+namespace {
+
+double minTime = 0.5;
+
+struct Result {
+  double seconds;
+  double allocations;
+};
+
+// run func until minTime has passed, keeping the fastest iteration
+Result run(const function<void()> &func) {
+  func();
+  Result result{0, 0};
+  double total = 0;
+  size_t iterations = 0;
+  size_t allocated = 0;
+  while (total < minTime || iterations < 3) {
+    size_t before = bench::allocationCount();
+    auto start = chrono::steady_clock::now();
+    func();
+    chrono::duration<double> cost = chrono::steady_clock::now() - start;
+    allocated += bench::allocationCount() - before;
+    if (iterations == 0 || cost.count() < result.seconds) {
+      result.seconds = cost.count();
+    }
+    total += cost.count();
+    ++iterations;
+  }
+  result.allocations = static_cast<double>(allocated) / static_cast<double>(iterations);
+  return result;
+}
+
+void walkObjects(const JsonValue &json, vector<pair<const JsonValue *, string>> &keys) {
+  if (json.isObject()) {
+    for (auto it = json.begin(); it != json.end(); ++it) {
+      keys.emplace_back(&json, it.key());
+      walkObjects(*it, keys);
+    }
+  } else if (json.isArray()) {
+    for (const auto &item: json) {
+      walkObjects(item, keys);
+    }
+  }
+}
+
+size_t iterate(const JsonValue &json) {
+  size_t count = 1;
+  if (json.isObject() || json.isArray()) {
+    for (auto it = json.begin(); it != json.end(); ++it) {
+      count += iterate(*it);
+    }
+  } else if (json.isString()) {
+    count += json.asString().size();
+  }
+  return count;
+}
+
+// JSON Lines made of the elements of the first array, in breadth first order, with enough of them
+string toLines(const JsonValue &json) {
+  vector<const JsonValue *> level{&json};
+  while (!level.empty()) {
+    vector<const JsonValue *> next;
+    for (const JsonValue *value: level) {
+      if (value->isArray() && value->size() >= 8) {
+        string lines;
+        for (const auto &item: *value) {
+          lines += item.toString();
+          lines += '\n';
+        }
+        return lines;
+      }
+      if (value->isArray() || value->isObject()) {
+        for (const auto &item: *value) {
+          next.push_back(&item);
+        }
+      }
+    }
+    level.swap(next);
+  }
+  return json.toString() + '\n';
+}
+
+// add and remove a member in every object, append and drop an element in every array
+void mutate(JsonValue &json) {
+  if (json.isObject()) {
+    for (auto &item: json) {
+      mutate(item);
+    }
+    json.push_back("__bench__", JsonValue(1));
+    json.erase("__bench__");
+  } else if (json.isArray()) {
+    for (auto &item: json) {
+      mutate(item);
+    }
+    json.push_back(JsonValue(1));
+    auto last = json.at(json.size() - 1);
+    json.erase(last);
+  }
+}
+
+// a corpus together with its parsed tree, shared by the cases that do not measure parsing
+struct Input {
+  bench::Corpus corpus;
+  JsonValue json;
+  vector<pair<const JsonValue *, string>> keys;
+  string lines;
+  // the last member of the root object
+  string last_key;
+  // the tree encoded as CBOR and MessagePack
+  string cbor;
+  string msgpack;
+};
+
+struct Case {
+  const char *name;
+  function<void(Input &)> body;
+  // measured over Input::lines instead of the corpus
+  bool on_lines = false;
+};
+
+volatile size_t sink;
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  // arguments naming a file are used as corpora, anything else filters the cases by name
+  vector<bench::Corpus> corpora;
+  vector<string> filters;
+  for (int i = 1; i < argc; ++i) {
+    string arg = argv[i];
+    if (arg.compare(0, 11, "--min-time=") == 0) {
+      minTime = atof(arg.c_str() + 11);
+      continue;
+    }
+    ifstream fin(arg, ios::binary);
+    if (fin.is_open()) {
+      corpora.push_back({arg, string(istreambuf_iterator<char>(fin), {})});
+    } else {
+      filters.push_back(arg);
+    }
+  }
+  if (corpora.empty()) {
+    corpora = bench::standardCorpora();
+  }
+
+  suger::JsonReader reader;
+  vector<Input> inputs(corpora.size());
+  for (size_t i = 0; i < corpora.size(); ++i) {
+    inputs[i].corpus = std::move(corpora[i]);
+    inputs[i].json = reader.parse(inputs[i].corpus.text);
+    walkObjects(inputs[i].json, inputs[i].keys);
+    inputs[i].lines = toLines(inputs[i].json);
+    if (inputs[i].json.isObject()) {
+      for (auto it = inputs[i].json.begin(); it != inputs[i].json.end(); ++it) {
+        inputs[i].last_key = it.key();
+      }
+    }
+    inputs[i].cbor = suger::toCbor(inputs[i].json);
+    inputs[i].msgpack = suger::toMessagePack(inputs[i].json);
+  }
+
+  suger::JsonReader indexed_reader;
+  indexed_reader.setStructuralIndex(true);
+  suger::JsonDocument doc;
+  suger::JsonBinaryReader binary_reader;
+  vector<Case> cases;
+  cases.push_back({"parse", [&](Input &input) {
+    JsonValue json;
+    reader.parse(input.corpus.text, json);
+  }});
+  cases.push_back({"parse_indexed", [&](Input &input) {
+    JsonValue json;
+    indexed_reader.parse(input.corpus.text, json);
+  }});
+  cases.push_back({"parse_document", [&](Input &input) {
+    reader.parse(input.corpus.text, doc);
+  }});
+  // MB/s of the binary cases is still over the size of the text
+  cases.push_back({"parse_cbor", [&](Input &input) {
+    sink = binary_reader.parseCbor(input.cbor).size();
+  }});
+  cases.push_back({"parse_msgpack", [&](Input &input) {
+    sink = binary_reader.parseMessagePack(input.msgpack).size();
+  }});
+  // the last member or element of the root, every other value is skipped
+  cases.push_back({"view_last", [&](Input &input) {
+    suger::JsonView view(input.corpus.text);
+    if (input.json.isObject()) {
+      sink = static_cast<size_t>(view[input.last_key].getType());
+    } else if (input.json.isArray() && !input.json.empty()) {
+      sink = static_cast<size_t>(view[input.json.size() - 1].getType());
+    }
+  }});
+  cases.push_back({"parse_lines", [&](Input &input) {
+    suger::JsonStreamReader stream(input.lines);
+    size_t count = 0;
+    while (stream.next(doc)) {
+      ++count;
+    }
+    sink = count;
+  }, true});
+  cases.push_back({"parse_lines_parallel", [&](Input &input) {
+    sink = suger::parseLinesParallel(input.lines).size();
+  }, true});
+  cases.push_back({"toString", [&](Input &input) {
+    sink = input.json.toString().size();
+  }});
+  cases.push_back({"toCbor", [&](Input &input) {
+    sink = suger::toCbor(input.json).size();
+  }});
+  cases.push_back({"toMessagePack", [&](Input &input) {
+    sink = suger::toMessagePack(input.json).size();
+  }});
+  cases.push_back({"lookup", [&](Input &input) {
+    size_t found = 0;
+    for (const auto &key: input.keys) {
+      found += (*key.first)[key.second].isNull() ? 0 : 1;
+    }
+    sink = found;
+  }});
+  cases.push_back({"iterate", [&](Input &input) {
+    sink = iterate(input.json);
+  }});
+  cases.push_back({"copy", [&](Input &input) {
+    JsonValue copy(input.json);
+    sink = copy.size();
+  }});
+  cases.push_back({"mutate", [&](Input &input) {
+    mutate(input.json);
+  }});
+
+  printf("%-22s %-24s %10s %10s %12s\n", "case", "corpus", "MB/s", "ms", "allocs");
+  for (const auto &item: cases) {
+    for (auto &input: inputs) {
+      const bench::Corpus &corpus = input.corpus;
+      string name = string(item.name) + "/" + corpus.name;
+      if (!filters.empty() && none_of(filters.begin(), filters.end(), [&](const string &filter) {
+        return name.find(filter) != string::npos;
+      })) {
+        continue;
+      }
+      Result result = run([&]() { item.body(input); });
+      size_t size = item.on_lines ? input.lines.size() : corpus.text.size();
+      double size_mb = static_cast<double>(size) / (1024 * 1024);
+      printf("%-22s %-24s %10.1f %10.3f %12.0f\n", item.name, corpus.name.c_str(),
+             size_mb / result.seconds, result.seconds * 1000, result.allocations);
+    }
+  }
+  return 0;
+}
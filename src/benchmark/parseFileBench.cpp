@@ -0,0 +1,82 @@
+// Copyright (c) 2023. SugerSalt
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "JsonReader.hpp"
+
+using namespace std;
+
+// write a synthetic pretty printed document of roughly target_size bytes
+static void generateFile(const string &path, size_t target_size) {
+  ofstream fout(path, ios::binary);
+  fout << "[\n";
+  size_t written = 2;
+  for (size_t i = 0; written < target_size; ++i) {
+    string item = (i == 0 ? "" : ",\n");
+    item += "  {\n    \"id\": " + to_string(i) +
+            ",\n    \"name\": \"record number " + to_string(i) +
+            "\",\n    \"price\": " + to_string(static_cast<double>(i) * 0.25) +
+            ",\n    \"tags\": [\"a\", \"b\", \"c\"],\n    \"valid\": true\n  }";
+    fout << item;
+    written += item.size();
+  }
+  fout << "\n]\n";
+}
+
+template<typename Func>
+static double measure(int rounds, Func func) {
+  double best = 0;
+  for (int i = 0; i < rounds; ++i) {
+    auto start = chrono::steady_clock::now();
+    func();
+    chrono::duration<double> cost = chrono::steady_clock::now() - start;
+    if (i == 0 || cost.count() < best) {
+      best = cost.count();
+    }
+  }
+  return best;
+}
+
+int main(int argc, char *argv[]) {
+  string path;
+  bool generated = false;
+  if (argc > 1) {
+    path = argv[1];
+  } else {
+    path = "parseFileBench.json";
+    generateFile(path, 32 * 1024 * 1024);
+    generated = true;
+  }
+  ifstream probe(path, ios::binary | ios::ate);
+  if (!probe.is_open()) {
+    cerr << "can not open " << path << endl;
+    return 1;
+  }
+  double size_mb = static_cast<double>(probe.tellg()) / (1024 * 1024);
+  probe.close();
+
+  const int rounds = 3;
+  suger::JsonReader reader;
+  double stream_cost = measure(rounds, [&]() {
+    ifstream fin(path, ios::binary);
+    suger::JsonValue json;
+    reader.parse(fin, json);
+  });
+  double file_cost = measure(rounds, [&]() {
+    suger::JsonValue json;
+    reader.parseFile(path, json);
+  });
+
+  cout << "file: " << path << " (" << size_mb << " MB), best of " << rounds << endl;
+  cout << "parse(std::istream&): " << stream_cost * 1000 << " ms, "
+       << size_mb / stream_cost << " MB/s" << endl;
+  cout << "parseFile(path):      " << file_cost * 1000 << " ms, "
+       << size_mb / file_cost << " MB/s" << endl;
+  if (generated) {
+    remove(path.c_str());
+  }
+  return 0;
+}
@@ -1,149 +1,469 @@
 // Copyright (c) 2023. SugerSalt
 
 #include "detail/JsonArray.hpp"
-#include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <iterator>
 #include <utility>
+#include "detail/number.hpp"
 
 namespace suger {
 namespace detail {
-JsonArray::JsonArray() : JsonBase(JsonType::Array), data_() {
 
+struct JsonArray::Packed {
+  JsonType type;
+  std::size_t size;
+  std::size_t capacity;
+  void *data;
+  // the JsonValue elements for read only access, built by the first reader
+  std::atomic<JsonList *> expanded;
+};
+
+namespace {
+
+std::size_t elementSize(JsonType type) {
+  return type == JsonType::Boolean ? sizeof(bool) : sizeof(int64_t);
 }
 
-JsonArray::JsonArray(const std::vector<bool> &value) : JsonBase(JsonType::Array) {
-  for (auto item: value) {
-    data_.emplace_back(item);
+bool fitsInt(int64_t value) {
+  return value >= INT_MIN && value <= INT_MAX;
+}
+
+// whether value can be an element of a packed array of type
+bool fitsPacked(JsonType type, const JsonValue &value) {
+  switch (value.getType()) {
+    case JsonType::Boolean:
+    case JsonType::Double:
+      return type == value.getType();
+    case JsonType::Int:
+      return type == JsonType::Int;
+    case JsonType::Long:
+      return type == JsonType::Long || (type == JsonType::Int && !fitsInt(value.asLong()));
+    default:
+      return false;
   }
 }
 
-JsonArray::JsonArray(const std::vector<int> &value) : JsonBase(JsonType::Array) {
-  for (auto item: value) {
-    data_.emplace_back(item);
+// the packed type of count values, Null if they are not of one kind
+JsonType packedTypeOf(const JsonValue *values, std::size_t count) {
+  JsonType type = values[0].getType();
+  if (type == JsonType::Long && !fitsInt(values[0].asLong())) {
+    type = JsonType::Int;
   }
+  if (type != JsonType::Boolean && type != JsonType::Int && type != JsonType::Long &&
+      type != JsonType::Double) {
+    return JsonType::Null;
+  }
+  for (std::size_t i = 1; i < count; ++i) {
+    if (!fitsPacked(type, values[i])) {
+      // a small Long among Long values that did not fit an int
+      if (type == JsonType::Int && values[i].isLong()) {
+        for (std::size_t j = 0; j <= i; ++j) {
+          if (!values[j].isLong()) return JsonType::Null;
+        }
+        type = JsonType::Long;
+        continue;
+      }
+      return JsonType::Null;
+    }
+  }
+  return type;
 }
-JsonArray::JsonArray(const std::vector<int64_t> &value) : JsonBase(JsonType::Array) {
-  for (auto item: value) {
-    data_.emplace_back(item);
+
+void storePacked(JsonType type, void *data, std::size_t index, const JsonValue &value) {
+  switch (type) {
+    case JsonType::Boolean:
+      static_cast<bool *>(data)[index] = value.asBoolean();
+      break;
+    case JsonType::Double:
+      static_cast<double *>(data)[index] = value.asDouble();
+      break;
+    default:
+      static_cast<int64_t *>(data)[index] = value.asLong();
+      break;
   }
 }
 
-JsonArray::JsonArray(const std::vector<double> &value) : JsonBase(JsonType::Array) {
-  for (auto item: value) {
-    data_.emplace_back(item);
+template<class List>
+void expandPacked(JsonType type, const void *data, std::size_t size, List &out) {
+  if (out.capacity() - out.size() < size) {
+    out.reserve(std::max(out.size() + size, out.capacity() * 2));
+  }
+  switch (type) {
+    case JsonType::Boolean:
+      for (std::size_t i = 0; i < size; ++i) {
+        out.emplace_back(static_cast<const bool *>(data)[i]);
+      }
+      break;
+    case JsonType::Double:
+      for (std::size_t i = 0; i < size; ++i) {
+        out.emplace_back(static_cast<const double *>(data)[i]);
+      }
+      break;
+    case JsonType::Int:
+      for (std::size_t i = 0; i < size; ++i) {
+        int64_t value = static_cast<const int64_t *>(data)[i];
+        if (fitsInt(value)) {
+          out.emplace_back(static_cast<int>(value));
+        } else {
+          out.emplace_back(value);
+        }
+      }
+      break;
+    default:
+      for (std::size_t i = 0; i < size; ++i) {
+        out.emplace_back(static_cast<const int64_t *>(data)[i]);
+      }
+      break;
   }
 }
 
-JsonArray::JsonArray(const std::vector<std::string> &value) : JsonBase(JsonType::Array) {
+// arena arrays are never destroyed, the list built for read only access is freed with the arena
+void releaseExpanded(void *packed) {
+  delete static_cast<std::atomic<JsonList *> *>(packed)->exchange(nullptr);
+}
+
+} // namespace
+
+const std::size_t JsonArray::kMinPackedSize;
+
+JsonArray::JsonArray() : JsonBase(JsonType::Array), data_(), packed_(nullptr) {
+
+}
+
+JsonArray::JsonArray(JsonArena *arena)
+    : JsonBase(JsonType::Array, arena != nullptr), data_(JsonAllocator<JsonValue>(arena)),
+      packed_(nullptr) {
+
+}
+
+JsonArray::JsonArray(const std::vector<bool> &value) : JsonBase(JsonType::Array), packed_(nullptr) {
+  if (value.empty()) return;
+  packed_ = createPacked(JsonType::Boolean, value.size());
+  std::copy(value.begin(), value.end(), static_cast<bool *>(packed_->data));
+  packed_->size = value.size();
+}
+
+JsonArray::JsonArray(const std::vector<int> &value) : JsonBase(JsonType::Array), packed_(nullptr) {
+  if (value.empty()) return;
+  packed_ = createPacked(JsonType::Int, value.size());
+  std::copy(value.begin(), value.end(), static_cast<int64_t *>(packed_->data));
+  packed_->size = value.size();
+}
+
+JsonArray::JsonArray(const std::vector<int64_t> &value)
+    : JsonBase(JsonType::Array), packed_(nullptr) {
+  if (value.empty()) return;
+  packed_ = createPacked(JsonType::Long, value.size());
+  std::memcpy(packed_->data, value.data(), value.size() * sizeof(int64_t));
+  packed_->size = value.size();
+}
+
+JsonArray::JsonArray(const std::vector<double> &value)
+    : JsonBase(JsonType::Array), packed_(nullptr) {
+  if (value.empty()) return;
+  packed_ = createPacked(JsonType::Double, value.size());
+  std::memcpy(packed_->data, value.data(), value.size() * sizeof(double));
+  packed_->size = value.size();
+}
+
+JsonArray::JsonArray(const std::vector<std::string> &value)
+    : JsonBase(JsonType::Array), packed_(nullptr) {
   for (const auto &item: value) {
     data_.emplace_back(item);
   }
 }
 
-JsonArray::JsonArray(const JsonArray::JsonList &value) : JsonBase(JsonType::Array), data_(value) {
+JsonArray::JsonArray(const std::vector<JsonValue> &value)
+    : JsonBase(JsonType::Array), data_(value.begin(), value.end()), packed_(nullptr) {
 
 }
 
+JsonArray::JsonArray(const JsonArray &other)
+    : JsonBase(other), data_(other.data_), packed_(nullptr) {
+  if (other.packed_ != nullptr) {
+    packed_ = createPacked(other.packed_->type, other.packed_->size);
+    std::memcpy(packed_->data, other.packed_->data,
+                other.packed_->size * elementSize(other.packed_->type));
+    packed_->size = other.packed_->size;
+  }
+}
+
+JsonArray::~JsonArray() {
+  if (!inArena()) {
+    releasePacked(packed_);
+  }
+}
+
 const JsonArray::JsonList &JsonArray::getValue() const {
-  return data_;
+  return packed_ != nullptr ? expanded() : data_;
 }
 
 JsonArray::JsonList & JsonArray::getRef() {
+  unpack();
   return data_;
 }
 
 void JsonArray::setValue(const JsonArray::JsonList &x) {
+  unpack();
   data_ = x;
 }
 
 std::size_t JsonArray::size() const {
-  return data_.size();
+  return packed_ != nullptr ? packed_->size : data_.size();
 }
 
 bool JsonArray::empty() const {
-  return data_.empty();
+  return size() == 0;
 }
 
-std::vector<JsonValue>::iterator JsonArray::begin() {
+JsonArray::JsonList::iterator JsonArray::begin() {
+  unpack();
   return data_.begin();
 }
 
-std::vector<JsonValue>::const_iterator JsonArray::begin() const {
-  return data_.begin();
+JsonArray::JsonList::const_iterator JsonArray::begin() const {
+  return getValue().begin();
 }
 
-std::vector<JsonValue>::iterator JsonArray::end() {
+JsonArray::JsonList::iterator JsonArray::end() {
+  unpack();
   return data_.end();
 }
 
-std::vector<JsonValue>::const_iterator JsonArray::end() const {
-  return data_.end();
+JsonArray::JsonList::const_iterator JsonArray::end() const {
+  return getValue().end();
 }
 
 void JsonArray::clear() {
+  unpack();
   data_.clear();
 }
 
-std::vector<JsonValue>::iterator
-JsonArray::insert(std::vector<JsonValue>::const_iterator pos, const JsonValue &value) {
+JsonArray::JsonList::iterator
+JsonArray::insert(JsonArray::JsonList::const_iterator pos, const JsonValue &value) {
+  unpack();
   return data_.insert(pos, value);
 }
 
-std::vector<JsonValue>::iterator
-JsonArray::insert(std::vector<JsonValue>::const_iterator pos, JsonValue &&value) {
+JsonArray::JsonList::iterator
+JsonArray::insert(JsonArray::JsonList::const_iterator pos, JsonValue &&value) {
+  unpack();
   return data_.insert(pos, std::move(value));
 }
 
 void JsonArray::push_back(const JsonValue &value) {
-  data_.push_back(value);
+  if (!pushPacked(value)) {
+    data_.push_back(value);
+  }
 }
 
 void JsonArray::push_back(JsonValue &&value) {
-  data_.emplace_back(std::move(value));
+  if (!pushPacked(value)) {
+    data_.emplace_back(std::move(value));
+  }
 }
 
-std::vector<JsonValue>::iterator JsonArray::erase(std::vector<JsonValue>::const_iterator pos) {
+JsonArray::JsonList::iterator JsonArray::erase(JsonArray::JsonList::const_iterator pos) {
+  unpack();
   return data_.erase(pos);
 }
 
-std::vector<JsonValue>::iterator JsonArray::erase(std::vector<JsonValue>::const_iterator first,
-  std::vector<JsonValue>::const_iterator last) {
+JsonArray::JsonList::iterator JsonArray::erase(JsonArray::JsonList::const_iterator first,
+  JsonArray::JsonList::const_iterator last) {
+  unpack();
   return data_.erase(first, last);
 }
 
 void JsonArray::pop_back() {
+  unpack();
   data_.pop_back();
 }
 
 JsonValue &JsonArray::operator[](std::size_t pos) {
+  unpack();
   return data_[pos];
 }
 
 const JsonValue &JsonArray::operator[](std::size_t pos) const {
-  return data_[pos];
+  return getValue()[pos];
 }
 
 void JsonArray::swap(JsonArray &other) {
   data_.swap(other.data_);
+  std::swap(packed_, other.packed_);
+}
+
+bool JsonArray::pack() {
+  return packed_ != nullptr || pack(data_.data(), data_.size());
+}
+
+bool JsonArray::pack(const JsonValue *values, std::size_t count) {
+  if (count == 0) return false;
+  JsonType type = packedTypeOf(values, count);
+  if (type == JsonType::Null) return false;
+  Packed *packed = createPacked(type, count);
+  for (std::size_t i = 0; i < count; ++i) {
+    storePacked(type, packed->data, i, values[i]);
+  }
+  packed->size = count;
+  releasePacked(packed_);
+  packed_ = packed;
+  JsonList(data_.get_allocator()).swap(data_);
+  return true;
+}
+
+bool JsonArray::isPacked() const {
+  return packed_ != nullptr;
+}
+
+JsonType JsonArray::packedType() const {
+  return packed_ != nullptr ? packed_->type : JsonType::Null;
+}
+
+const void *JsonArray::packedData() const {
+  return packed_ != nullptr ? packed_->data : nullptr;
+}
+
+const JsonArray::JsonList &JsonArray::expanded() const {
+  JsonList *list = packed_->expanded.load(std::memory_order_acquire);
+  if (list == nullptr) {
+    // heap memory, the arena can not be used by concurrent readers
+    auto built = new JsonList();
+    expandPacked(packed_->type, packed_->data, packed_->size, *built);
+    if (packed_->expanded.compare_exchange_strong(list, built, std::memory_order_acq_rel,
+                                                  std::memory_order_acquire)) {
+      list = built;
+    } else {
+      delete built;
+    }
+  }
+  return *list;
+}
+
+void JsonArray::unpack() {
+  if (packed_ == nullptr) return;
+  JsonList *list = packed_->expanded.load(std::memory_order_acquire);
+  if (list == nullptr) {
+    data_.clear();
+    expandPacked(packed_->type, packed_->data, packed_->size, data_);
+  } else if (list->get_allocator() == data_.get_allocator()) {
+    // references handed out by read only access stay valid
+    data_.swap(*list);
+  } else {
+    data_.assign(std::make_move_iterator(list->begin()), std::make_move_iterator(list->end()));
+  }
+  releasePacked(packed_);
+  packed_ = nullptr;
+}
+
+bool JsonArray::pushPacked(const JsonValue &value) {
+  if (packed_ == nullptr) {
+    return false;
+  }
+  if (!fitsPacked(packed_->type, value)) {
+    unpack();
+    return false;
+  }
+  // values expanded by read only access before are kept in step with the packed ones
+  JsonList *list = packed_->expanded.load(std::memory_order_acquire);
+  if (packed_->size == packed_->capacity) {
+    Packed *packed = createPacked(packed_->type, packed_->capacity * 2);
+    std::memcpy(packed->data, packed_->data, packed_->size * elementSize(packed_->type));
+    packed->size = packed_->size;
+    packed->expanded.store(list, std::memory_order_relaxed);
+    packed_->expanded.store(nullptr, std::memory_order_relaxed);
+    releasePacked(packed_);
+    packed_ = packed;
+  }
+  std::size_t index = packed_->size++;
+  storePacked(packed_->type, packed_->data, index, value);
+  if (list != nullptr) {
+    const char *element = static_cast<const char *>(packed_->data);
+    expandPacked(packed_->type, element + index * elementSize(packed_->type), 1, *list);
+  }
+  return true;
+}
+
+JsonArray::Packed *JsonArray::createPacked(JsonType type, std::size_t capacity) const {
+  JsonArena *arena = data_.get_allocator().arena();
+  std::size_t bytes = capacity * elementSize(type);
+  Packed *packed;
+  if (arena == nullptr) {
+    packed = new Packed();
+    packed->data = ::operator new(bytes);
+  } else {
+    packed = arena->create<Packed>();
+    packed->data = arena->allocate(bytes, alignof(int64_t));
+    arena->addCleanup(&packed->expanded, releaseExpanded);
+  }
+  packed->type = type;
+  packed->size = 0;
+  packed->capacity = capacity;
+  packed->expanded.store(nullptr, std::memory_order_relaxed);
+  return packed;
+}
+
+void JsonArray::releasePacked(Packed *packed) const {
+  if (packed == nullptr) return;
+  if (data_.get_allocator().arena() == nullptr) {
+    delete packed->expanded.load(std::memory_order_relaxed);
+    ::operator delete(packed->data);
+    delete packed;
+  } else {
+    releaseExpanded(&packed->expanded);
+  }
 }
 
 std::string JsonArray::toString() const {
-  std::stringstream out;
-  toDumpStream(out);
-  return out.str();
+  std::string out;
+  dump(out);
+  return out;
 }
 
-std::ostream &JsonArray::toDumpStream(std::ostream &out) const {
-  out << '[';
+void JsonArray::dump(std::string &out) const {
+  if (packed_ != nullptr) {
+    dumpPacked(out);
+    return;
+  }
+  out += '[';
   bool not_first = false;
   for (auto &value: data_) {
     if (not_first) {
-      out << ',';
+      out += ',';
     }
     not_first = true;
-    out << value;
+    value.dump(out);
   }
-  out << ']';
-  return out;
+  out += ']';
+}
+
+void JsonArray::dumpPacked(std::string &out) const {
+  char buf[kNumberBufferSize];
+  out += '[';
+  for (std::size_t i = 0; i < packed_->size; ++i) {
+    if (i != 0) {
+      out += ',';
+    }
+    switch (packed_->type) {
+      case JsonType::Boolean:
+        if (static_cast<const bool *>(packed_->data)[i]) {
+          out.append("true", 4);
+        } else {
+          out.append("false", 5);
+        }
+        break;
+      case JsonType::Double:
+        out.append(buf, writeDouble(static_cast<const double *>(packed_->data)[i], buf));
+        break;
+      default:
+        out.append(buf, writeInt64(static_cast<const int64_t *>(packed_->data)[i], buf));
+        break;
+    }
+  }
+  out += ']';
 }
 } // detail
 } // suger
\ No newline at end of file
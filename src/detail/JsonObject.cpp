@@ -1,115 +1,339 @@
 // Copyright (c) 2023. SugerSalt
 
 #include "detail/JsonObject.hpp"
-#include <sstream>
+#include <functional>
+#include <utility>
 #include "JsonError.hpp"
 #include "detail/tool.hpp"
 
 namespace suger {
 namespace detail {
-JsonObject::JsonObject() : JsonBase(JsonType::Object), data_() {
+JsonObject::JsonObject()
+    : JsonBase(JsonType::Object), shape_(nullptr), keys_(), values_(), index_(),
+      keys_cleanup_(false) {
 
 }
 
-const JsonObject::ObjectList &JsonObject::getValue() const {
-  return data_;
+JsonObject::JsonObject(JsonArena *arena)
+    : JsonBase(JsonType::Object, arena != nullptr), shape_(nullptr),
+      keys_(KeyList::allocator_type(arena)), values_(ValueList::allocator_type(arena)),
+      index_(IndexList::allocator_type(arena)), keys_cleanup_(false) {
+
+}
+
+JsonObject::JsonObject(const JsonObject &other)
+    : JsonBase(other), shape_(nullptr), keys_(other.keys().begin(), other.keys().end()),
+      values_(other.values_), index_(other.index().begin(), other.index().end()),
+      keys_cleanup_(false) {
+
+}
+
+const JsonObject::KeyList &JsonObject::getKeys() const {
+  return keys();
 }
 
-JsonObject::ObjectList &JsonObject::getRef() {
-  return data_;
+const JsonObject::ValueList &JsonObject::getValues() const {
+  return values_;
 }
 
-void JsonObject::setValue(const JsonObject::ObjectList &x) {
-  data_ = x;
+JsonObject::ValueList &JsonObject::getValuesRef() {
+  return values_;
 }
 
 std::size_t JsonObject::size() const {
-  return data_.size();
+  return values_.size();
 }
 
 bool JsonObject::empty() const {
-  return data_.empty();
+  return values_.empty();
+}
+
+void JsonObject::clear() {
+  shape_ = nullptr;
+  keys_.clear();
+  values_.clear();
+  index_.clear();
+}
+
+void JsonObject::reserve(std::size_t n) {
+  unshare();
+  keys_.reserve(n);
+  values_.reserve(n);
+  // size the index once instead of growing it while the members are added
+  if (n > kIndexThreshold && index_.size() < n * 2) {
+    rebuildIndex(n);
+  }
 }
 
-JsonObject::ObjectList::iterator JsonObject::begin() {
-  return data_.begin();
+bool JsonObject::insert(const std::string &key, const JsonValue &value) {
+  bool appended;
+  std::size_t pos = probe(key, appended);
+  if (appended) {
+    values_[pos] = value;
+  }
+  return appended;
 }
 
-JsonObject::ObjectList::const_iterator JsonObject::begin() const {
-  return data_.begin();
+bool JsonObject::insert(const std::string &key, JsonValue &&value) {
+  bool appended;
+  std::size_t pos = probe(key, appended);
+  if (appended) {
+    values_[pos] = std::move(value);
+  }
+  return appended;
 }
 
-JsonObject::ObjectList::iterator JsonObject::end() {
-  return data_.end();
+bool JsonObject::insert(std::string &&key, JsonValue &&value) {
+  bool appended;
+  std::size_t pos = probe(std::move(key), appended);
+  if (appended) {
+    values_[pos] = std::move(value);
+  }
+  return appended;
 }
 
-JsonObject::ObjectList::const_iterator JsonObject::end() const {
-  return data_.end();
+std::size_t JsonObject::findOrAppend(const std::string &key, bool &appended) {
+  return probe(key, appended);
 }
 
-void JsonObject::clear() {
-  data_.clear();
+std::size_t JsonObject::findOrAppend(JsonKey &&key, bool &appended) {
+  return probe(std::move(key), appended);
 }
 
-bool JsonObject::insert(const std::string &key, const JsonValue &value) {
-  return data_.emplace(key, value).second;
+void JsonObject::insertMulti(JsonKey &&key, JsonValue &&value) {
+  append(std::move(key));
+  values_.back() = std::move(value);
 }
 
-bool JsonObject::insert(const std::string &key, JsonValue &&value) {
-  return data_.emplace(key, std::move(value)).second;
+void JsonObject::share(const JsonObject &shape, JsonValue *values) {
+  shape_ = &shape;
+  values_.append(values, shape.size());
 }
 
-JsonObject::ObjectList::iterator JsonObject::erase(JsonObject::ObjectList::const_iterator pos) {
-  return data_.erase(pos);
+bool JsonObject::shared() const {
+  return shape_ != nullptr;
+}
+
+void JsonObject::copyKeys(const JsonObject &other) {
+  keys_.assign(other.keys().begin(), other.keys().end());
+  index_.assign(other.index().begin(), other.index().end());
+  values_.resize(other.size());
+}
+
+void JsonObject::erase(std::size_t pos) {
+  unshare();
+  keys_.erase(keys_.begin() + static_cast<std::ptrdiff_t>(pos));
+  values_.erase(pos);
+  rebuildIndex(keys_.size());
 }
 
 std::size_t JsonObject::erase(const std::string &key) {
-  return data_.erase(key);
+  std::size_t pos = find(key);
+  if (pos == size()) {
+    return 0;
+  }
+  erase(pos);
+  return 1;
 }
 
 JsonValue &JsonObject::operator[](const std::string &key) {
-  return data_[key];
+  bool appended;
+  return values_[probe(key, appended)];
 }
 
 const JsonValue &JsonObject::operator[](const std::string &key) const {
-  auto it = data_.find(key);
-  if (it == data_.end()) {
+  std::size_t pos = find(key);
+  if (pos == size()) {
     throw key_error(key);
   }
-  return it->second;
+  return values_[pos];
 }
 
 void JsonObject::swap(JsonObject &other) {
-  data_.swap(other.data_);
+  std::swap(shape_, other.shape_);
+  keys_.swap(other.keys_);
+  values_.swap(other.values_);
+  index_.swap(other.index_);
+  // the cleanup of an arena is registered for the object, not for its keys
+  checkKeysCleanup();
+  other.checkKeysCleanup();
 }
 
-JsonObject::ObjectList::iterator JsonObject::find(const std::string &key) {
-  return data_.find(key);
+std::size_t JsonObject::find(const std::string &key) const {
+  const KeyList &keys = this->keys();
+  const IndexList &index = this->index();
+  if (index.empty()) {
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      if (keys[i].str() == key) {
+        return i;
+      }
+    }
+    return keys.size();
+  }
+  std::size_t mask = index.size() - 1;
+  for (std::size_t slot = std::hash<std::string>()(key) & mask; index[slot] != 0;
+       slot = (slot + 1) & mask) {
+    std::size_t pos = index[slot] - 1;
+    if (keys[pos].str() == key) {
+      return pos;
+    }
+  }
+  return keys.size();
 }
 
-JsonObject::ObjectList::const_iterator JsonObject::find(const std::string &key) const {
-  return data_.find(key);
+std::string JsonObject::toString() const {
+  std::string out;
+  dump(out);
+  return out;
 }
 
-std::string JsonObject::toString() const {
-  std::stringstream ss;
-  toDumpStream(ss);
-  return ss.str();
+void JsonObject::dump(std::string &out) const {
+  const KeyList &keys = this->keys();
+  out += '{';
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    if (i != 0) {
+      out += ',';
+    }
+    out += '\"';
+    addTranslatedChar(keys[i].str(), out);
+    out += "\":";
+    values_[i].dump(out);
+  }
+  out += '}';
+}
+
+namespace {
+
+const std::string &keyString(const std::string &key) {
+  return key;
+}
+
+const std::string &keyString(const JsonKey &key) {
+  return key.str();
 }
 
-std::ostream &JsonObject::toDumpStream(std::ostream &out) const {
-  out << '{';
-  bool not_first = false;
-  for (auto &item: data_) {
-    if (not_first) {
-      out << ',';
+std::size_t keyHash(const std::string &key) {
+  return std::hash<std::string>()(key);
+}
+
+std::size_t keyHash(const JsonKey &key) {
+  return key.hash();
+}
+
+} // namespace
+
+const JsonObject::KeyList &JsonObject::keys() const {
+  return shape_ != nullptr ? shape_->keys_ : keys_;
+}
+
+const JsonObject::IndexList &JsonObject::index() const {
+  return shape_ != nullptr ? shape_->index_ : index_;
+}
+
+void JsonObject::unshare() {
+  if (shape_ == nullptr) {
+    return;
+  }
+  keys_.assign(shape_->keys_.begin(), shape_->keys_.end());
+  index_.assign(shape_->index_.begin(), shape_->index_.end());
+  shape_ = nullptr;
+  checkKeysCleanup();
+}
+
+template<class Key>
+std::size_t JsonObject::probe(Key &&key, bool &appended) {
+  unshare();
+  const std::string &str = keyString(key);
+  appended = false;
+  if (index_.empty()) {
+    std::size_t pos = find(str);
+    if (pos == size()) {
+      append(std::forward<Key>(key));
+      appended = true;
     }
-    not_first = true;
-    addTranslatedChar(item.first, out << '\"') << "\":" << item.second;
+    return pos;
   }
-  out << '}';
-  return out;
+  std::size_t mask = index_.size() - 1;
+  std::size_t slot = keyHash(key) & mask;
+  for (; index_[slot] != 0; slot = (slot + 1) & mask) {
+    std::size_t pos = index_[slot] - 1;
+    if (keys_[pos].str() == str) {
+      return pos;
+    }
+  }
+  // the empty slot which ended the probe is where the key belongs
+  pushMember(std::forward<Key>(key));
+  appended = true;
+  if (keys_.size() * 2 <= index_.size()) {
+    index_[slot] = static_cast<uint32_t>(keys_.size());
+  } else {
+    rebuildIndex(keys_.size());
+  }
+  return keys_.size() - 1;
+}
+
+void JsonObject::append(JsonKey key) {
+  unshare();
+  pushMember(std::move(key));
+  if (!index_.empty() && keys_.size() * 2 <= index_.size()) {
+    addToIndex(keys_.size() - 1);
+  } else if (keys_.size() > kIndexThreshold) {
+    rebuildIndex(keys_.size());
+  }
+}
+
+void JsonObject::pushMember(JsonKey key) {
+  keys_.push_back(std::move(key));
+  values_.push_back(JsonValue());
+  if (keys_.back().usesHeap()) {
+    addKeysCleanup();
+  }
+}
+
+void JsonObject::addKeysCleanup() {
+  JsonArena *arena = keys_.get_allocator().arena();
+  if (arena != nullptr && !keys_cleanup_) {
+    arena->addCleanup(this, &JsonObject::destroyKeys);
+    keys_cleanup_ = true;
+  }
+}
+
+void JsonObject::checkKeysCleanup() {
+  for (const auto &key: keys_) {
+    if (key.usesHeap()) {
+      addKeysCleanup();
+      break;
+    }
+  }
+}
+
+void JsonObject::addToIndex(std::size_t pos) {
+  std::size_t mask = index_.size() - 1;
+  std::size_t slot = keys_[pos].hash() & mask;
+  while (index_[slot] != 0) {
+    slot = (slot + 1) & mask;
+  }
+  index_[slot] = static_cast<uint32_t>(pos + 1);
+}
+
+void JsonObject::rebuildIndex(std::size_t count) {
+  index_.clear();
+  if (count <= kIndexThreshold) {
+    return;
+  }
+  std::size_t capacity = 64;
+  while (capacity < count * 4) {
+    capacity *= 2;
+  }
+  index_.assign(capacity, 0);
+  for (std::size_t i = 0; i < keys_.size(); ++i) {
+    addToIndex(i);
+  }
+}
+
+void JsonObject::destroyKeys(void *object) {
+  static_cast<JsonObject *>(object)->keys_.clear();
 }
 
 } // suger
-} // detail
\ No newline at end of file
+} // detail
@@ -1,6 +1,7 @@
 // Copyright (c) 2023. SugerSalt
 
 #include "detail/JsonString.hpp"
+#include <utility>
 #include "detail/tool.hpp"
 
 namespace suger {
@@ -17,6 +18,11 @@ JsonString::JsonString(const char *value) : JsonBase(JsonType::String), data_(va
 
 }
 
+JsonString::JsonString(std::string &&value, bool in_arena)
+    : JsonBase(JsonType::String, in_arena), data_(std::move(value)) {
+
+}
+
 const std::string &JsonString::getValue() const {
   return data_;
 }
@@ -33,11 +39,10 @@ std::string JsonString::toString() const {
   return data_;
 }
 
-std::ostream &JsonString::toDumpStream(std::ostream &out) const {
-  out << '\"';
+void JsonString::dump(std::string &out) const {
+  out += '\"';
   addTranslatedChar(data_, out);
-  out << '\"';
-  return out;
+  out += '\"';
 }
 
 } // suger
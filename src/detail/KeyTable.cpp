@@ -0,0 +1,55 @@
+// Copyright (c) 2023. SugerSalt
+
+#include "detail/KeyTable.hpp"
+#include <functional>
+
+namespace suger {
+namespace detail {
+
+const std::size_t KeyTable::kMaxKeys;
+
+KeyTable::KeyTable() : keys_(), index_(64, nullptr) {
+
+}
+
+const InternedKey *KeyTable::intern(const std::string &key) {
+  if ((keys_.size() + 1) * 2 > index_.size()) {
+    grow();
+  }
+  std::size_t hash = std::hash<std::string>()(key);
+  std::size_t mask = index_.size() - 1;
+  std::size_t slot = hash & mask;
+  for (; index_[slot] != nullptr; slot = (slot + 1) & mask) {
+    const InternedKey *entry = index_[slot];
+    if (entry->hash == hash && entry->str == key) {
+      return entry;
+    }
+  }
+  keys_.push_back(InternedKey{hash, key});
+  index_[slot] = &keys_.back();
+  return index_[slot];
+}
+
+void KeyTable::clear() {
+  keys_.clear();
+  index_.assign(64, nullptr);
+}
+
+std::size_t KeyTable::size() const {
+  return keys_.size();
+}
+
+void KeyTable::grow() {
+  index_.assign(index_.size() * 2, nullptr);
+  std::size_t mask = index_.size() - 1;
+  for (const auto &entry: keys_) {
+    std::size_t slot = entry.hash & mask;
+    while (index_[slot] != nullptr) {
+      slot = (slot + 1) & mask;
+    }
+    index_[slot] = &entry;
+  }
+}
+
+} // detail
+} // suger
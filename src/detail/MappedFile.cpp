@@ -0,0 +1,73 @@
+// Copyright (c) 2023. SugerSalt
+
+#include "detail/MappedFile.hpp"
+#include "JsonError.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SUGERJSON_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace suger {
+namespace detail {
+
+#ifdef SUGERJSON_USE_MMAP
+MappedFile::MappedFile(const std::string &path) : data_(nullptr), size_(0) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw parse_error("Can not open file: " + path);
+  }
+  struct stat st{};
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    throw parse_error("Can not read file: " + path);
+  }
+  size_ = static_cast<std::size_t>(st.st_size);
+  if (size_ > 0) {
+    void *addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+      ::close(fd);
+      throw parse_error("Can not map file: " + path);
+    }
+    ::madvise(addr, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char *>(addr);
+  }
+  ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    ::munmap(const_cast<char *>(data_), size_);
+  }
+}
+#else
+MappedFile::MappedFile(const std::string &path) : data_(nullptr), size_(0) {
+  std::ifstream fin(path, std::ios::binary | std::ios::ate);
+  if (!fin.is_open()) {
+    throw parse_error("Can not open file: " + path);
+  }
+  content_.resize(static_cast<std::size_t>(fin.tellg()));
+  fin.seekg(0);
+  fin.read(&content_[0], static_cast<std::streamsize>(content_.size()));
+  data_ = content_.data();
+  size_ = content_.size();
+}
+
+MappedFile::~MappedFile() = default;
+#endif
+
+const char *MappedFile::data() const {
+  return data_;
+}
+
+std::size_t MappedFile::size() const {
+  return size_;
+}
+
+} // detail
+} // suger
@@ -0,0 +1,127 @@
+// Copyright (c) 2023. SugerSalt
+
+#include "detail/StructuralIndex.hpp"
+#include <algorithm>
+#include <cstring>
+#include "detail/scan.hpp"
+
+namespace suger {
+namespace detail {
+namespace {
+
+const std::size_t kBlockSize = 64;
+const std::size_t kWindowSize = 1 << 15;
+
+inline int lowestBit64(uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(mask);
+#else
+  int n = 0;
+  while (!(mask & 1u)) {
+    mask >>= 1;
+    ++n;
+  }
+  return n;
+#endif
+}
+
+// bit i is the xor of the bits 0 to i
+inline uint64_t prefixXor(uint64_t mask) {
+  mask ^= mask << 1;
+  mask ^= mask << 2;
+  mask ^= mask << 4;
+  mask ^= mask << 8;
+  mask ^= mask << 16;
+  mask ^= mask << 32;
+  return mask;
+}
+
+} // namespace
+
+StructuralIndex::StructuralIndex()
+    : cur_(nullptr), last_(nullptr), window_(nullptr), indexed_(nullptr), end_(nullptr),
+      escaped_(0), in_string_(0), in_run_(0) {
+
+}
+
+void StructuralIndex::reset(const char *begin, const char *end) {
+  cur_ = last_ = offsets_.data();
+  window_ = begin;
+  indexed_ = begin;
+  end_ = end;
+  escaped_ = 0;
+  in_string_ = 0;
+  in_run_ = 0;
+}
+
+const char *StructuralIndex::nextWindow(const char *pos) {
+  while (indexed_ != end_) {
+    indexWindow();
+    while (cur_ != last_ && window_ + *cur_ < pos) {
+      ++cur_;
+    }
+    if (cur_ != last_) {
+      return window_ + *cur_;
+    }
+  }
+  return end_;
+}
+
+void StructuralIndex::indexWindow() {
+  std::size_t size = std::min(static_cast<std::size_t>(end_ - indexed_), kWindowSize);
+  // every character may be a token
+  offsets_.resize(kWindowSize);
+  uint32_t *out = offsets_.data();
+  window_ = indexed_;
+  std::size_t offset = 0;
+  for (; offset + kBlockSize <= size; offset += kBlockSize) {
+    out = indexBlock(window_ + offset, static_cast<uint32_t>(offset), out);
+  }
+  if (offset != size) {
+    // blanks add no tokens
+    char block[kBlockSize];
+    std::memset(block, ' ', kBlockSize);
+    std::memcpy(block, window_ + offset, size - offset);
+    out = indexBlock(block, static_cast<uint32_t>(offset), out);
+  }
+  indexed_ = window_ + size;
+  cur_ = offsets_.data();
+  last_ = out;
+}
+
+uint32_t *StructuralIndex::indexBlock(const char *block, uint32_t offset, uint32_t *out) {
+  BlockMasks masks;
+  classifyBlock(block, masks);
+
+  // a backslash escapes the next character unless it is escaped itself
+  uint64_t escaped = escaped_;
+  escaped_ = 0;
+  for (uint64_t backslash = masks.backslash; backslash != 0; backslash &= backslash - 1) {
+    int i = lowestBit64(backslash);
+    if ((escaped >> i & 1u) == 0) {
+      if (i == 63) {
+        escaped_ = 1;
+      } else {
+        escaped |= uint64_t{1} << (i + 1);
+      }
+    }
+  }
+
+  uint64_t quote = masks.quote & ~escaped;
+  // the opening quote and the characters of a string, not the closing quote
+  uint64_t in_string = prefixXor(quote) ^ in_string_;
+  in_string_ = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+  uint64_t run = ~(masks.blank | masks.structural | masks.quote | in_string);
+  uint64_t run_start = run & ~(run << 1 | in_run_);
+  in_run_ = run >> 63;
+
+  uint64_t tokens = (masks.structural & ~in_string) | quote | run_start |
+                    ((masks.backslash | masks.control) & in_string);
+  for (; tokens != 0; tokens &= tokens - 1) {
+    *out++ = offset + static_cast<uint32_t>(lowestBit64(tokens));
+  }
+  return out;
+}
+
+} // detail
+} // suger
@@ -0,0 +1,127 @@
+// Copyright (c) 2023. SugerSalt
+
+#include "detail/ValueChunks.hpp"
+#include <new>
+#include <utility>
+
+namespace suger {
+namespace detail {
+
+namespace {
+
+inline int highestBit(std::size_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return 63 - __builtin_clzll(x);
+#else
+  int n = 0;
+  while (x >>= 1) {
+    ++n;
+  }
+  return n;
+#endif
+}
+
+} // namespace
+
+ValueChunks::ValueChunks(const allocator_type &alloc)
+    : first_(nullptr), first_capacity_(0), size_(0), more_(alloc) {
+
+}
+
+ValueChunks::ValueChunks(const ValueChunks &other)
+    : first_(nullptr), first_capacity_(0), size_(0), more_() {
+  reserve(other.size_);
+  for (std::size_t i = 0; i < other.size_; ++i) {
+    new(&(*this)[size_]) JsonValue(other[i]);
+    ++size_;
+  }
+}
+
+ValueChunks::~ValueChunks() {
+  clear();
+  allocator_type alloc(more_.get_allocator());
+  if (first_ != nullptr) {
+    alloc.deallocate(first_, first_capacity_);
+  }
+  for (std::size_t k = 0; k < more_.size(); ++k) {
+    alloc.deallocate(more_[k], first_capacity_ << (k + 1));
+  }
+}
+
+std::size_t ValueChunks::capacity() const {
+  return first_capacity_ * ((std::size_t(2) << more_.size()) - 1);
+}
+
+void ValueChunks::reserve(std::size_t n) {
+  if (first_ == nullptr) {
+    if (n != 0) {
+      first_ = allocator_type(more_.get_allocator()).allocate(n);
+      first_capacity_ = n;
+    }
+    return;
+  }
+  while (capacity() < n) {
+    addChunk(first_capacity_ << (more_.size() + 1));
+  }
+}
+
+void ValueChunks::push_back(JsonValue &&value) {
+  if (size_ == capacity()) {
+    reserve(first_ == nullptr ? kFirstChunk : size_ + 1);
+  }
+  new(&(*this)[size_]) JsonValue(std::move(value));
+  ++size_;
+}
+
+void ValueChunks::append(JsonValue *values, std::size_t n) {
+  reserve(size_ + n);
+  for (std::size_t i = 0; i < n; ++i) {
+    new(&(*this)[size_]) JsonValue(std::move(values[i]));
+    ++size_;
+  }
+}
+
+void ValueChunks::resize(std::size_t n) {
+  reserve(n);
+  while (size_ < n) {
+    new(&(*this)[size_]) JsonValue();
+    ++size_;
+  }
+}
+
+void ValueChunks::erase(std::size_t pos) {
+  for (std::size_t i = pos; i + 1 < size_; ++i) {
+    (*this)[i] = std::move((*this)[i + 1]);
+  }
+  (*this)[size_ - 1].~JsonValue();
+  --size_;
+}
+
+void ValueChunks::clear() {
+  for (std::size_t i = 0; i < size_; ++i) {
+    (*this)[i].~JsonValue();
+  }
+  size_ = 0;
+}
+
+void ValueChunks::swap(ValueChunks &other) noexcept {
+  std::swap(first_, other.first_);
+  std::swap(first_capacity_, other.first_capacity_);
+  std::swap(size_, other.size_);
+  more_.swap(other.more_);
+}
+
+// chunk k of more_ starts at first_capacity_ * (2^(k + 1) - 1)
+JsonValue &ValueChunks::locate(std::size_t pos) const {
+  int chunk = highestBit(pos / first_capacity_ + 1);
+  std::size_t start = first_capacity_ * ((std::size_t(1) << chunk) - 1);
+  return more_[static_cast<std::size_t>(chunk) - 1][pos - start];
+}
+
+void ValueChunks::addChunk(std::size_t n) {
+  more_.reserve(more_.size() + 1);
+  more_.push_back(allocator_type(more_.get_allocator()).allocate(n));
+}
+
+} // suger
+} // detail
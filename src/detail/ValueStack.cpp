@@ -0,0 +1,167 @@
+// Copyright (c) 2023. SugerSalt
+
+#include "detail/ValueStack.hpp"
+#include <iterator>
+#include <utility>
+#include "detail/JsonImp.hpp"
+#include "detail/KeyTable.hpp"
+
+namespace suger {
+namespace detail {
+
+const std::size_t ValueStack::kShapeCache;
+
+ValueStack::ValueStack()
+    : arena_(nullptr), policy_(DuplicateKeyPolicy::Reject), key_table_(nullptr),
+      packed_arrays_(true), values_(),
+      keys_(), shapes_(), next_shape_(0) {
+
+}
+
+void ValueStack::setArena(JsonArena *arena) {
+  arena_ = arena;
+  clearShapes();
+}
+
+void ValueStack::setDuplicateKeyPolicy(DuplicateKeyPolicy policy) {
+  policy_ = policy;
+}
+
+DuplicateKeyPolicy ValueStack::duplicateKeyPolicy() const {
+  return policy_;
+}
+
+void ValueStack::setKeyTable(KeyTable *table) {
+  key_table_ = table;
+}
+
+void ValueStack::setPackedArrays(bool enable) {
+  packed_arrays_ = enable;
+}
+
+bool ValueStack::packedArrays() const {
+  return packed_arrays_;
+}
+
+void ValueStack::clear() {
+  values_.clear();
+  keys_.clear();
+  clearShapes();
+}
+
+std::size_t ValueStack::size() const {
+  return values_.size();
+}
+
+void ValueStack::pushNull() {
+  values_.emplace_back();
+}
+
+void ValueStack::pushString(std::string &value) {
+  values_.push_back(JsonValue(std::move(value), arena_));
+}
+
+void ValueStack::pushKey(std::string &key) {
+  if (key_table_ != nullptr) {
+    keys_.emplace_back(key_table_->intern(key));
+  } else {
+    keys_.emplace_back(std::move(key));
+  }
+}
+
+bool ValueStack::endObject(std::size_t count, std::size_t &duplicate) {
+  std::size_t base = keys_.size() - count;
+  std::size_t value_base = values_.size() - count;
+  JsonValue object(JsonType::Object, arena_);
+  auto &data = *static_cast<JsonObject *>(object.data_.ptr);
+  if (arena_ != nullptr && shareKeys(data, count)) {
+    keys_.erase(keys_.begin() + static_cast<std::ptrdiff_t>(base), keys_.end());
+    values_.erase(values_.begin() + static_cast<std::ptrdiff_t>(value_base), values_.end());
+    values_.push_back(std::move(object));
+    return true;
+  }
+  data.reserve(count);
+  auto &values = data.getValuesRef();
+  for (std::size_t i = 0; i < count; ++i) {
+    JsonKey &key = keys_[base + i];
+    JsonValue &value = values_[value_base + i];
+    if (policy_ == DuplicateKeyPolicy::KeepAll) {
+      data.insertMulti(std::move(key), std::move(value));
+      continue;
+    }
+    bool appended;
+    std::size_t pos = data.findOrAppend(std::move(key), appended);
+    if (appended || policy_ == DuplicateKeyPolicy::LastWins) {
+      values[pos] = std::move(value);
+    } else if (policy_ == DuplicateKeyPolicy::Reject) {
+      duplicate = base + i;
+      return false;
+    }
+  }
+  keys_.erase(keys_.begin() + static_cast<std::ptrdiff_t>(base), keys_.end());
+  values_.erase(values_.begin() + static_cast<std::ptrdiff_t>(value_base), values_.end());
+  if (arena_ != nullptr && count != 0) {
+    shapes_[next_shape_] = &data;
+    next_shape_ = (next_shape_ + 1) % kShapeCache;
+  }
+  values_.push_back(std::move(object));
+  return true;
+}
+
+// The objects of an arena are never changed after they are built, so their keys can be shared.
+bool ValueStack::shareKeys(JsonObject &object, std::size_t count) {
+  std::size_t base = keys_.size() - count;
+  for (const JsonObject *shape: shapes_) {
+    if (shape == nullptr || shape->size() != count) {
+      continue;
+    }
+    const auto &keys = shape->getKeys();
+    std::size_t i = 0;
+    while (i < count && keys[i] == keys_[base + i]) {
+      ++i;
+    }
+    if (i == count) {
+      object.share(*shape, &values_[values_.size() - count]);
+      return true;
+    }
+  }
+  return false;
+}
+
+void ValueStack::clearShapes() {
+  for (auto &shape: shapes_) {
+    shape = nullptr;
+  }
+  next_shape_ = 0;
+}
+
+void ValueStack::endArray(std::size_t count) {
+  auto first = values_.end() - static_cast<std::ptrdiff_t>(count);
+  JsonValue array(JsonType::Array, arena_);
+  auto &node = *static_cast<JsonArray *>(array.data_.ptr);
+  if (!packed_arrays_ || count < JsonArray::kMinPackedSize || !node.pack(&*first, count)) {
+    auto &data = node.getRef();
+    data.reserve(count);
+    data.insert(data.end(), std::make_move_iterator(first),
+                std::make_move_iterator(values_.end()));
+  }
+  values_.erase(first, values_.end());
+  values_.push_back(std::move(array));
+}
+
+std::size_t ValueStack::keyCount() const {
+  return keys_.size();
+}
+
+const std::string &ValueStack::key(std::size_t index) const {
+  return keys_[index].str();
+}
+
+JsonValue ValueStack::pop() {
+  JsonValue value = std::move(values_.back());
+  values_.pop_back();
+  return value;
+}
+
+} // detail
+} // suger
@@ -0,0 +1,169 @@
+// Copyright (c) 2023. SugerSalt
+
+#include "detail/number.hpp"
+#include <cmath>
+#include <string>
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace suger {
+namespace detail {
+namespace {
+
+const double kExactPow10[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+const uint64_t kMaxExactMantissa = uint64_t(1) << 53;
+
+double parseDoubleSlow(const char *begin, const char *end, int64_t magnitude) {
+  double result = 0.0;
+#if defined(__cpp_lib_to_chars)
+  auto ret = std::from_chars(begin, end, result);
+  if (ret.ec == std::errc::result_out_of_range) {
+    // from_chars leaves the value untouched when it overflows or underflows
+    result = magnitude > 0 ? HUGE_VAL : 0.0;
+  }
+#else
+  // strtod needs a terminated copy and uses the '.' of the "C" locale
+  (void) magnitude;
+  std::string text(begin, end);
+  result = std::strtod(text.c_str(), nullptr);
+#endif
+  return result;
+}
+
+} // namespace
+
+double parseDouble(const char *begin, const char *end, uint64_t mantissa, int significant,
+                   int64_t exponent) {
+  if (mantissa == 0 && significant == 0) {
+    return 0.0;
+  }
+  // Clinger's fast path: both operands are exact, so one rounding gives the exact result
+  if (significant <= 19 && mantissa <= kMaxExactMantissa && exponent >= -22 && exponent <= 22) {
+    auto value = static_cast<double>(mantissa);
+    if (exponent < 0) {
+      return value / kExactPow10[-exponent];
+    }
+    return value * kExactPow10[exponent];
+  }
+  return parseDoubleSlow(begin, end, exponent + significant);
+}
+
+int writeInt64(int64_t x, char *buf) {
+#if defined(__cpp_lib_to_chars)
+  return static_cast<int>(std::to_chars(buf, buf + kNumberBufferSize, x).ptr - buf);
+#else
+  return std::snprintf(buf, kNumberBufferSize, "%lld", static_cast<long long>(x));
+#endif
+}
+
+int writeDouble(double x, char *buf) {
+  if (!std::isfinite(x)) {
+    std::memcpy(buf, "null", 4);
+    return 4;
+  }
+  int len = 0;
+#if defined(__cpp_lib_to_chars)
+  len = static_cast<int>(std::to_chars(buf, buf + kNumberBufferSize, x).ptr - buf);
+#else
+  // the shortest of %.15g, %.16g and %.17g which reads back unchanged
+  for (int precision = 15; precision <= 17; ++precision) {
+    len = std::snprintf(buf, kNumberBufferSize, "%.*g", precision, x);
+    if (std::strtod(buf, nullptr) == x) {
+      break;
+    }
+  }
+#endif
+  for (int i = 0; i < len; ++i) {
+    if (buf[i] == '.' || buf[i] == 'e') {
+      return len;
+    }
+  }
+  buf[len++] = '.';
+  buf[len++] = '0';
+  return len;
+}
+
+const char *scanNumber(const char *pos, const char *end, ParsedNumber &number) {
+  bool negative = false;
+  bool is_int = true;
+  uint64_t mantissa = 0;
+  int significant = 0;
+  int64_t exponent = 0;
+
+  auto isDigit = [](char ch) { return ch >= '0' && ch <= '9'; };
+  auto addDigit = [&](char ch) {
+    auto digit = static_cast<uint64_t>(ch - '0');
+    if (mantissa != 0 || digit != 0) {
+      ++significant;
+    }
+    mantissa = mantissa * 10 + digit;
+  };
+
+  if (*pos == '-') {
+    negative = true;
+    ++pos;
+  } else if (*pos == '+') {
+    ++pos;
+  }
+  const char *digits = pos;
+  while (pos != end && isDigit(*pos)) {
+    addDigit(*pos);
+    ++pos;
+  }
+  if (pos != end && *pos == '.') {
+    is_int = false;
+    ++pos;
+    while (pos != end && isDigit(*pos)) {
+      addDigit(*pos);
+      --exponent;
+      ++pos;
+    }
+  }
+  if (pos != end && (*pos == 'e' || *pos == 'E')) {
+    is_int = false;
+    ++pos;
+    bool exponent_negative = false;
+    if (pos != end && *pos == '-') {
+      exponent_negative = true;
+      ++pos;
+    } else if (pos != end && *pos == '+') {
+      ++pos;
+    }
+    int64_t written = 0;
+    while (pos != end && isDigit(*pos)) {
+      if (written < 100000) {
+        written = written * 10 + (*pos - '0');
+      }
+      ++pos;
+    }
+    exponent += exponent_negative ? -written : written;
+  }
+
+  if (is_int && significant <= 19) {
+    if (mantissa <= static_cast<uint64_t>(INT32_MAX) + negative) {
+      number.type = JsonType::Int;
+      number.i = static_cast<int>(negative ? -static_cast<int64_t>(mantissa)
+                                           : static_cast<int64_t>(mantissa));
+      return pos;
+    } else if (mantissa <= static_cast<uint64_t>(INT64_MAX) + negative) {
+      number.type = JsonType::Long;
+      number.i64 = negative ? static_cast<int64_t>(0 - mantissa) : static_cast<int64_t>(mantissa);
+      return pos;
+    }
+  }
+  double result = parseDouble(digits, pos, mantissa, significant, exponent);
+  number.type = JsonType::Double;
+  number.d = negative ? -result : result;
+  return pos;
+}
+
+} // detail
+} // suger
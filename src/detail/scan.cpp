@@ -0,0 +1,283 @@
+// Copyright (c) 2023. SugerSalt
+
+#include "detail/scan.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define SUGERJSON_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define SUGERJSON_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+namespace suger {
+namespace detail {
+namespace {
+
+inline bool isBlank(char ch) {
+  return ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r';
+}
+
+inline bool isStringSpecial(char ch) {
+  return ch == '\"' || ch == '\\' || static_cast<unsigned char>(ch) < 0x20;
+}
+
+inline int lowestBit(unsigned mask) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctz(mask);
+#else
+  int n = 0;
+  while (!(mask & 1u)) {
+    mask >>= 1;
+    ++n;
+  }
+  return n;
+#endif
+}
+
+const char *skipBlankScalar(const char *pos, const char *end) {
+  while (pos != end && isBlank(*pos)) {
+    ++pos;
+  }
+  return pos;
+}
+
+const char *findStringSpecialScalar(const char *pos, const char *end) {
+  while (pos != end && !isStringSpecial(*pos)) {
+    ++pos;
+  }
+  return pos;
+}
+
+#ifndef SUGERJSON_SSE2
+inline bool isStructural(char ch) {
+  return ch == '{' || ch == '}' || ch == '[' || ch == ']' || ch == ':' || ch == ',';
+}
+
+void classifyBlockScalar(const char *block, BlockMasks &masks) {
+  masks = BlockMasks{0, 0, 0, 0, 0};
+  for (int i = 0; i < 64; ++i) {
+    uint64_t bit = uint64_t{1} << i;
+    char ch = block[i];
+    if (ch == '\"') {
+      masks.quote |= bit;
+    } else if (ch == '\\') {
+      masks.backslash |= bit;
+    } else if (isBlank(ch)) {
+      masks.blank |= bit;
+    } else if (isStructural(ch)) {
+      masks.structural |= bit;
+    }
+    if (static_cast<unsigned char>(ch) < 0x20) {
+      masks.control |= bit;
+    }
+  }
+}
+#endif
+
+#ifdef SUGERJSON_SSE2
+const char *skipBlankSSE2(const char *pos, const char *end) {
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i newline = _mm_set1_epi8('\n');
+  const __m128i tab = _mm_set1_epi8('\t');
+  const __m128i carriage = _mm_set1_epi8('\r');
+  while (end - pos >= 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+    __m128i blank = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, newline)),
+      _mm_or_si128(_mm_cmpeq_epi8(chunk, tab), _mm_cmpeq_epi8(chunk, carriage)));
+    unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(blank)) & 0xFFFFu;
+    if (mask != 0) {
+      return pos + lowestBit(mask);
+    }
+    pos += 16;
+  }
+  return skipBlankScalar(pos, end);
+}
+
+const char *findStringSpecialSSE2(const char *pos, const char *end) {
+  const __m128i quote = _mm_set1_epi8('\"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i control = _mm_set1_epi8(0x1F);
+  while (end - pos >= 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+    // max(ch, 0x1F) == 0x1F  <=>  ch <= 0x1F as unsigned
+    __m128i special = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+      _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control));
+    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+    if (mask != 0) {
+      return pos + lowestBit(mask);
+    }
+    pos += 16;
+  }
+  return findStringSpecialScalar(pos, end);
+}
+
+inline uint64_t bits(__m128i match) {
+  return static_cast<unsigned>(_mm_movemask_epi8(match));
+}
+
+void classifyBlockSSE2(const char *block, BlockMasks &masks) {
+  const __m128i quote = _mm_set1_epi8('\"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i newline = _mm_set1_epi8('\n');
+  const __m128i tab = _mm_set1_epi8('\t');
+  const __m128i carriage = _mm_set1_epi8('\r');
+  const __m128i control = _mm_set1_epi8(0x1F);
+  const __m128i open_bracket = _mm_set1_epi8('[');
+  const __m128i close_bracket = _mm_set1_epi8(']');
+  const __m128i open_brace = _mm_set1_epi8('{');
+  const __m128i close_brace = _mm_set1_epi8('}');
+  const __m128i colon = _mm_set1_epi8(':');
+  const __m128i comma = _mm_set1_epi8(',');
+  masks = BlockMasks{0, 0, 0, 0, 0};
+  for (int i = 0; i < 64; i += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i));
+    __m128i blank = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, newline)),
+      _mm_or_si128(_mm_cmpeq_epi8(chunk, tab), _mm_cmpeq_epi8(chunk, carriage)));
+    __m128i brackets = _mm_or_si128(_mm_cmpeq_epi8(chunk, open_bracket),
+                                    _mm_cmpeq_epi8(chunk, close_bracket));
+    __m128i braces = _mm_or_si128(_mm_cmpeq_epi8(chunk, open_brace),
+                                  _mm_cmpeq_epi8(chunk, close_brace));
+    __m128i separators = _mm_or_si128(_mm_cmpeq_epi8(chunk, colon),
+                                      _mm_cmpeq_epi8(chunk, comma));
+    __m128i structural = _mm_or_si128(_mm_or_si128(brackets, braces), separators);
+    masks.quote |= bits(_mm_cmpeq_epi8(chunk, quote)) << i;
+    masks.backslash |= bits(_mm_cmpeq_epi8(chunk, backslash)) << i;
+    masks.blank |= bits(blank) << i;
+    masks.structural |= bits(structural) << i;
+    masks.control |= bits(_mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control)) << i;
+  }
+}
+#endif
+
+#ifdef SUGERJSON_AVX2
+__attribute__((target("avx2")))
+const char *skipBlankAVX2(const char *pos, const char *end) {
+  const __m256i space = _mm256_set1_epi8(' ');
+  const __m256i newline = _mm256_set1_epi8('\n');
+  const __m256i tab = _mm256_set1_epi8('\t');
+  const __m256i carriage = _mm256_set1_epi8('\r');
+  while (end - pos >= 32) {
+    __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pos));
+    __m256i blank = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, newline)),
+      _mm256_or_si256(_mm256_cmpeq_epi8(chunk, tab), _mm256_cmpeq_epi8(chunk, carriage)));
+    unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(blank));
+    if (mask != 0) {
+      return pos + lowestBit(mask);
+    }
+    pos += 32;
+  }
+  return skipBlankSSE2(pos, end);
+}
+
+__attribute__((target("avx2")))
+const char *findStringSpecialAVX2(const char *pos, const char *end) {
+  const __m256i quote = _mm256_set1_epi8('\"');
+  const __m256i backslash = _mm256_set1_epi8('\\');
+  const __m256i control = _mm256_set1_epi8(0x1F);
+  while (end - pos >= 32) {
+    __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pos));
+    __m256i special = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)),
+      _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control), control));
+    unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(special));
+    if (mask != 0) {
+      return pos + lowestBit(mask);
+    }
+    pos += 32;
+  }
+  return findStringSpecialSSE2(pos, end);
+}
+
+__attribute__((target("avx2")))
+inline uint64_t bits(__m256i match) {
+  return static_cast<uint32_t>(_mm256_movemask_epi8(match));
+}
+
+__attribute__((target("avx2")))
+void classifyBlockAVX2(const char *block, BlockMasks &masks) {
+  const __m256i quote = _mm256_set1_epi8('\"');
+  const __m256i backslash = _mm256_set1_epi8('\\');
+  const __m256i control = _mm256_set1_epi8(0x1F);
+  // Looked up by the low 4 bits, a character is a blank if it equals its entry. The entries
+  // which are no blank have other low bits, so nothing else can match.
+  const __m256i blank_table = _mm256_setr_epi8(
+    ' ', 100, 100, 100, 17, 100, 113, 2, 100, '\t', '\n', 112, 100, '\r', 100, 100,
+    ' ', 100, 100, 100, 17, 100, 113, 2, 100, '\t', '\n', 112, 100, '\r', 100, 100);
+  // The same for the structural characters, with 0x20 set so that '[' ']' become '{' '}'.
+  // 0x0C and 0x1A match as well and are taken out with the control characters.
+  const __m256i structural_table = _mm256_setr_epi8(
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, ':', '{', ',', '}', 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, ':', '{', ',', '}', 0, 0);
+  const __m256i bit_20 = _mm256_set1_epi8(0x20);
+  masks = BlockMasks{0, 0, 0, 0, 0};
+  for (int i = 0; i < 64; i += 32) {
+    __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + i));
+    __m256i blank = _mm256_cmpeq_epi8(chunk, _mm256_shuffle_epi8(blank_table, chunk));
+    __m256i structural = _mm256_cmpeq_epi8(_mm256_or_si256(chunk, bit_20),
+                                           _mm256_shuffle_epi8(structural_table, chunk));
+    uint64_t control_bits =
+      bits(_mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control), control)) << i;
+    masks.quote |= bits(_mm256_cmpeq_epi8(chunk, quote)) << i;
+    masks.backslash |= bits(_mm256_cmpeq_epi8(chunk, backslash)) << i;
+    masks.blank |= bits(blank) << i;
+    masks.structural |= (bits(structural) << i) & ~control_bits;
+    masks.control |= control_bits;
+  }
+}
+#endif
+
+using ScanFunc = const char *(*)(const char *, const char *);
+using ClassifyFunc = void (*)(const char *, BlockMasks &);
+
+struct ScanKernels {
+  ScanFunc skip_blank;
+  ScanFunc find_string_special;
+  ClassifyFunc classify_block;
+};
+
+ScanKernels selectKernels() {
+#ifdef SUGERJSON_AVX2
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return {skipBlankAVX2, findStringSpecialAVX2, classifyBlockAVX2};
+  }
+#endif
+#ifdef SUGERJSON_SSE2
+  return {skipBlankSSE2, findStringSpecialSSE2, classifyBlockSSE2};
+#else
+  return {skipBlankScalar, findStringSpecialScalar, classifyBlockScalar};
+#endif
+}
+
+const ScanKernels &kernels() {
+  static const ScanKernels selected = selectKernels();
+  return selected;
+}
+
+} // namespace
+
+const char *skipBlank(const char *pos, const char *end) {
+  // most gaps between tokens are empty or a single character
+  if (pos == end || !isBlank(*pos)) return pos;
+  ++pos;
+  if (pos == end || !isBlank(*pos)) return pos;
+  return kernels().skip_blank(pos, end);
+}
+
+const char *findStringSpecial(const char *pos, const char *end) {
+  return kernels().find_string_special(pos, end);
+}
+
+void classifyBlock(const char *block, BlockMasks &masks) {
+  kernels().classify_block(block, masks);
+}
+
+} // detail
+} // suger
@@ -1,24 +1,65 @@
 // Copyright (c) 2023. SugerSalt
 
 #include "detail/tool.hpp"
-#include <sstream>
+#include <cstdint>
+#include "JsonError.hpp"
 
 namespace suger{
 
+namespace {
+
+// the letter written after '\\' for each character which has to be escaped, 0 otherwise
+struct EscapeTable {
+  char letter[256];
+
+  EscapeTable() : letter() {
+    letter[static_cast<unsigned char>('\"')] = '\"';
+    letter[static_cast<unsigned char>('\'')] = '\'';
+    letter[static_cast<unsigned char>('\\')] = '\\';
+    letter[static_cast<unsigned char>('\b')] = 'b';
+    letter[static_cast<unsigned char>('\f')] = 'f';
+    letter[static_cast<unsigned char>('\n')] = 'n';
+    letter[static_cast<unsigned char>('\r')] = 'r';
+    letter[static_cast<unsigned char>('\t')] = 't';
+  }
+};
+
+const EscapeTable kEscape;
+
+}  // namespace
+
 std::string addTranslatedChar(const std::string &str){
-  std::stringstream ss;
-  addTranslatedChar(str,ss);
-  return ss.str();
+  std::string out;
+  addTranslatedChar(str, out);
+  return out;
 }
 
-std::ostream &addTranslatedChar(const std::string &str, std::ostream &out){
-  for(auto & ch:str){
-    if (ch=='\"'||ch=='\''||ch=='\\'){
-      out << '\\';
+void addTranslatedChar(const std::string &str, std::string &out){
+  const char *run = str.data();
+  const char *end = str.data() + str.size();
+  for (const char *pos = run; pos != end; ++pos) {
+    char letter = kEscape.letter[static_cast<unsigned char>(*pos)];
+    if (letter != 0) {
+      out.append(run, pos);
+      out += '\\';
+      out += letter;
+      run = pos + 1;
     }
-    out << ch;
   }
-  return out;
+  out.append(run, end);
+}
+
+void throwParseError(const std::string &msg, const char *begin, const char *pos) {
+  int64_t row = 0;
+  const char *line_begin = begin;
+  for (const char *it = begin; it != pos; ++it) {
+    if (*it == '\n') {
+      ++row;
+      line_begin = it + 1;
+    }
+  }
+  throw parse_error(msg + " At row: " + std::to_string(row + 1) + ", col: " +
+                    std::to_string(pos - line_begin + 1));
 }
 
 }  // suger
\ No newline at end of file
@@ -0,0 +1,73 @@
+// Copyright (c) 2023. SugerSalt
+
+#include <iostream>
+#include <vector>
+#include "JsonReader.hpp"
+#include "JsonHandler.hpp"
+#include "JsonError.hpp"
+
+using namespace std;
+
+// collects the "id" and "name" of the records in a top level array without building a tree
+class RecordHandler : public suger::JsonHandler {
+public:
+  struct Record {
+    int64_t id;
+    string name;
+  };
+  vector<Record> records;
+
+  bool onStartObject() override {
+    if (++depth_ == 1) {
+      records.push_back({0, ""});
+    }
+    return true;
+  }
+  bool onEndObject(size_t) override {
+    --depth_;
+    return true;
+  }
+  bool onKey(const string &key) override {
+    field_ = depth_ == 1 ? key : "";
+    return true;
+  }
+  bool onInt(int value) override {
+    return onInt64(value);
+  }
+  bool onInt64(int64_t value) override {
+    if (field_ == "id") {
+      records.back().id = value;
+    }
+    return true;
+  }
+  bool onString(const string &value) override {
+    if (field_ == "name") {
+      records.back().name = value;
+    }
+    return true;
+  }
+
+private:
+  int depth_ = 0;
+  string field_;
+};
+
+int main() {
+  string str = R"([
+  {"id": 1, "name": "first", "tags": ["a", "b"], "detail": {"name": "ignored"}},
+  {"id": 2, "name": "second", "tags": [], "detail": null},
+  {"id": 3000000000, "name": "third"}
+])";
+  suger::JsonReader reader;
+  RecordHandler handler;
+  try {
+    reader.parse(str, handler);
+  } catch (suger::parse_error &e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+  for (const auto &record: handler.records) {
+    cout << record.id << ": " << record.name << endl;
+  }
+  return 0;
+}
@@ -3,6 +3,7 @@
 #include <iostream>
 #include "JsonValue.hpp"
 #include "JsonError.hpp"
+#include "JsonReader.hpp"
 
 using namespace std;
 
@@ -42,5 +43,32 @@ int main() {
   printInt(json2["intValue"]);
   json2.push_back("intValue2", 5);
   printInt(json2["intValue2"]);
+  cout << "-------------------------------------" << endl;
+
+  // a parsed object has no spare capacity, copying a member to a new key grows it
+  suger::JsonValue json3 = suger::JsonReader().parse(R"({"a": [1, 2]})");
+  json3["b"] = json3["a"];
+  json3.push_back("c", json3["a"]);
+  cout << json3 << endl;
+  // a member reference stays valid while members are added
+  suger::JsonValue &array = json3["a"];
+  json3["d"] = true;
+  array.push_back(3);
+  json3["e"] = static_cast<int>(array.size());
+  cout << json3 << endl;
+  cout << "-------------------------------------" << endl;
+
+  // a copy taken after a reference into a shared value is independent of it
+  suger::JsonValue json4 = suger::JsonReader().parse(R"({"k": 1, "s": {"m": [1, 2]}})");
+  json4.share();
+  suger::JsonValue &k = json4["k"];
+  suger::JsonValue json5 = json4;
+  k = 5;
+  cout << json4 << endl;  // {"k":5,"s":{"m":[1,2]}}
+  cout << json5 << endl;  // {"k":1,"s":{"m":[1,2]}}
+  if (json5["k"].asInt() != 1) {
+    cerr << "the copy was changed through a reference into the original" << endl;
+    return 1;
+  }
   return 0;
 }